@@ -0,0 +1,74 @@
+/*
+ * Test of SerLCDEventLoop: updates queued for the display go out from an
+ * epoll loop, and handling an event never sleeps through the display's
+ * pauses.
+ */
+#include "serLCD_linux_eventloop.h"
+#include "serLCD_queue.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { if (!(cond)) { printf("  FAILED line %d: %s\n", __LINE__, #cond); failures++; } } while (0)
+
+/*
+ * Collects what the display is sent.
+ */
+class RecordingTransport : public SerLCDTransport {
+
+public:
+  char sent[256];
+  int length = 0;
+  virtual bool beginTransmission() { return true; }
+  virtual bool transmit(uint8_t data) {
+    if (length < (int)sizeof(sent) - 1) { sent[length++] = data; sent[length] = '\0'; }
+    return true;
+  }
+  virtual bool endTransmission() { return true; }
+};
+
+int main() {
+  RecordingTransport transport;
+  SerLCD lcd;
+  SerLCDQueue updates;
+  SerLCDEventLoop loop(lcd);
+
+  CHECK(lcd.begin(transport));
+  updates.start(lcd);
+
+  int epollFd = epoll_create1(EPOLL_CLOEXEC);
+  CHECK(epollFd >= 0);
+  CHECK(loop.attach(epollFd));
+
+  //Each update is followed by a 10 ms pause before the display takes the next
+  CHECK(updates.post(0, 0, "one"));
+  CHECK(updates.post(0, 1, "two"));
+  CHECK(updates.post(0, 2, "three"));
+  loop.rearm();
+
+  unsigned long start = millis();
+  unsigned long longest = 0;
+  while (millis() - start < 200) {
+    struct epoll_event events[4];
+    int n = epoll_wait(epollFd, events, 4, 50);
+
+    for (int i = 0; i < n; i++) {
+      unsigned long before = micros();
+      CHECK(loop.handle(events[i]));
+      if (micros() - before > longest) { longest = micros() - before; }
+    } // for
+  } // while
+
+  CHECK(strstr(transport.sent, "one") != NULL);
+  CHECK(strstr(transport.sent, "two") != NULL);
+  CHECK(strstr(transport.sent, "three") != NULL);
+  printf("longest handle(): %lu us\n", longest);
+  CHECK(longest < 5000);
+
+  loop.detach();
+  printf(failures ? "%d failures\n" : "passed\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * Test of SerLCDGroup's worker threads: displays on two buses are served
+ * by a thread each, so transactions on one bus overlap those on the other,
+ * and every queued update still reaches its display.
+ */
+#include "serLCD_group.h"
+#include "serLCD_queue.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define SLOW_TRANSACTION 5 //Time a fake bus takes per transaction in ms
+
+static int failures = 0;
+static volatile int inFlight = 0; //Transactions in progress on all buses
+static volatile int mostInFlight = 0;
+
+#define CHECK(cond) \
+  do { if (!(cond)) { printf("  FAILED line %d: %s\n", __LINE__, #cond); failures++; } } while (0)
+
+/*
+ * A slow bus that collects what the display is sent.
+ */
+class SlowTransport : public SerLCDTransport {
+
+public:
+  char sent[512];
+  int length = 0;
+  virtual bool beginTransmission() {
+    int now = __atomic_add_fetch(&inFlight, 1, __ATOMIC_ACQ_REL);
+    int most = __atomic_load_n(&mostInFlight, __ATOMIC_ACQUIRE);
+    while (now > most && !__atomic_compare_exchange_n(&mostInFlight, &most, now, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) { }
+    return true;
+  }
+  virtual bool transmit(uint8_t data) {
+    if (length < (int)sizeof(sent) - 1) { sent[length++] = data; sent[length] = '\0'; }
+    return true;
+  }
+  virtual bool endTransmission() {
+    struct timespec ts = { 0, SLOW_TRANSACTION * 1000000L };
+    nanosleep(&ts, NULL);
+    __atomic_sub_fetch(&inFlight, 1, __ATOMIC_ACQ_REL);
+    return true;
+  }
+};
+
+static bool delivered(SlowTransport &transport, const char *const *texts, int count) {
+  for (int i = 0; i < count; i++) {
+    if (strstr(transport.sent, texts[i]) == NULL) { return false; }
+  } // for
+  return true;
+}
+
+int main() {
+  static const char *const texts[] = { "alpha", "bravo", "charlie", "delta" };
+  SlowTransport transports[2];
+  SerLCD lcds[2];
+  SerLCDQueue queues[2];
+  SerLCDGroup group;
+
+  for (int bus = 0; bus < 2; bus++) {
+    CHECK(lcds[bus].begin(transports[bus]));
+    CHECK(group.add(lcds[bus], bus));
+    queues[bus].start(lcds[bus]);
+
+    for (int row = 0; row < 4; row++) {
+      CHECK(queues[bus].post(0, row, texts[row]));
+    } // for
+  } // for
+
+  //Four updates take about 60 ms per bus; the output is only read once the workers are gone
+  CHECK(group.startThreads());
+  delay(500);
+  group.stopThreads();
+
+  CHECK(delivered(transports[0], texts, 4));
+  CHECK(delivered(transports[1], texts, 4));
+  printf("most transactions at once: %d\n", mostInFlight);
+  CHECK(mostInFlight == 2);
+
+  printf(failures ? "%d failures\n" : "passed\n", failures);
+  return failures ? 1 : 0;
+}
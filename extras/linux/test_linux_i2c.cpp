@@ -0,0 +1,162 @@
+/*
+ * Test of SerLCDLinuxI2C against a fake i2c-dev adapter.
+ *
+ * The test is linked with -Wl,--wrap=ioctl, so the transport's ioctl() calls
+ * on the fake node land in __wrap_ioctl() below, which records what a real
+ * adapter would put on the wire. The fake can refuse I2C_RDWR like an
+ * SMBus-only adapter (i2c-stub), to exercise the fallback.
+ */
+#include "serLCD_cI2C.h"
+#include "serLCD_linux_i2c.h"
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+#define MAX_WRITES 64
+
+//One write as seen on the bus
+struct Write {
+  int address;
+  int length;
+  uint8_t bytes[LINUX_I2C_BUFFER_SIZE];
+};
+
+//The fake adapter
+static int fakeFd = -1;
+static bool plainI2C = true; //false to act like an SMBus-only adapter
+static int slaveAddress = -1;
+static Write writes[MAX_WRITES];
+static int writeCount = 0;
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { if (!(cond)) { printf("  FAILED line %d: %s\n", __LINE__, #cond); failures++; } } while (0)
+
+static void record(int address, const uint8_t *bytes, int length) {
+  if (writeCount == MAX_WRITES) { return; }
+
+  Write &w = writes[writeCount++];
+  w.address = address;
+  w.length = length;
+  memcpy(w.bytes, bytes, length);
+}
+
+extern "C" int __real_ioctl(int fd, unsigned long request, ...);
+
+extern "C" int __wrap_ioctl(int fd, unsigned long request, ...) {
+  va_list args;
+  va_start(args, request);
+  void *arg = va_arg(args, void *);
+  va_end(args);
+
+  if (fd != fakeFd) { return __real_ioctl(fd, request, arg); }
+
+  switch (request) {
+    case I2C_RDWR: {
+      if (!plainI2C) {
+        errno = EOPNOTSUPP;
+        return -1;
+      }
+      struct i2c_rdwr_ioctl_data *transfer = (struct i2c_rdwr_ioctl_data *)arg;
+      for (unsigned i = 0; i < transfer->nmsgs; i++) {
+        record(transfer->msgs[i].addr, transfer->msgs[i].buf, transfer->msgs[i].len);
+      }
+      return transfer->nmsgs;
+    }
+    case I2C_SLAVE:
+      slaveAddress = (int)(long)arg;
+      return 0;
+    case I2C_SMBUS: {
+      struct i2c_smbus_ioctl_data *transfer = (struct i2c_smbus_ioctl_data *)arg;
+      uint8_t bytes[I2C_SMBUS_BLOCK_MAX + 1];
+      if (slaveAddress < 0 || transfer->read_write != I2C_SMBUS_WRITE) { break; }
+
+      bytes[0] = transfer->command;
+      if (transfer->size == I2C_SMBUS_BYTE) {
+        record(slaveAddress, bytes, 1);
+        return 0;
+      }
+      if (transfer->size == I2C_SMBUS_I2C_BLOCK_DATA && transfer->data->block[0] <= I2C_SMBUS_BLOCK_MAX) {
+        memcpy(&bytes[1], &transfer->data->block[1], transfer->data->block[0]);
+        record(slaveAddress, bytes, transfer->data->block[0] + 1);
+        return 0;
+      }
+      break;
+    }
+  } // switch
+
+  errno = EINVAL;
+  return -1;
+}
+
+/*
+ * Everything sent to an address, as one stream.
+ */
+static int stream(int address, uint8_t *out, int size) {
+  int n = 0;
+
+  for (int i = 0; i < writeCount; i++) {
+    for (int j = 0; j < writes[i].length && n < size && writes[i].address == address; j++) {
+      out[n++] = writes[i].bytes[j];
+    }
+  }
+  return n;
+}
+
+/*
+ * Drive a display through the transport. Returns the number of bytes sent to 0x72.
+ */
+static int scenario(bool plain, uint8_t *sent, int size, uint8_t *moved, int *movedLength) {
+  SerLCDLinuxI2C bus("/dev/null");
+  SerLCD lcd;
+
+  plainI2C = plain;
+  slaveAddress = -1;
+  writeCount = 0;
+
+  CHECK(bus.open());
+  fakeFd = bus.fd();
+
+  CHECK(lcd.begin(bus));
+  CHECK(lcd.print("Hi") == 2);
+  CHECK(lcd.setCursor(2, 1));
+  CHECK(lcd.print("A line of text long enough to wrap") == 34);
+  CHECK(bus.smbus() == !plain);
+
+  CHECK(lcd.setAddress(0x73));
+  CHECK(lcd.print("!") == 1);
+
+  int n = stream(0x72, sent, size);
+  *movedLength = stream(0x73, moved, size);
+  fakeFd = -1;
+  return n;
+}
+
+int main() {
+  uint8_t plain[512], smbus[512], plainMoved[512], smbusMoved[512];
+  int plainMovedLength, smbusMovedLength;
+
+  printf("plain I2C adapter\n");
+  int plainLength = scenario(true, plain, sizeof(plain), plainMoved, &plainMovedLength);
+
+  //init(): display control, entry mode and clear in one transaction
+  const uint8_t init[] = { SPECIAL_COMMAND, LCD_DISPLAYCONTROL | LCD_DISPLAYON, SPECIAL_COMMAND,
+                           LCD_ENTRYMODESET | LCD_ENTRYLEFT, SETTING_COMMAND, CLEAR_COMMAND };
+  CHECK(writeCount > 2);
+  CHECK(writes[0].address == 0x72 && writes[0].length == 6 && memcmp(writes[0].bytes, init, 6) == 0);
+  CHECK(writes[1].length == 2 && memcmp(writes[1].bytes, "Hi", 2) == 0);
+  CHECK(plainMovedLength == 1 && plainMoved[0] == '!');
+
+  printf("SMBus-only adapter\n");
+  int smbusLength = scenario(false, smbus, sizeof(smbus), smbusMoved, &smbusMovedLength);
+
+  //Same bytes on the wire, in writes the SMBus protocol allows
+  CHECK(smbusLength == plainLength && memcmp(smbus, plain, plainLength) == 0);
+  CHECK(smbusMovedLength == plainMovedLength && memcmp(smbusMoved, plainMoved, plainMovedLength) == 0);
+  for (int i = 0; i < writeCount; i++) { CHECK(writes[i].length <= LINUX_I2C_SMBUS_BLOCK); }
+
+  printf(failures ? "%d failures\n" : "passed\n", failures);
+  return failures ? 1 : 0;
+}
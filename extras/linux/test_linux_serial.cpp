@@ -0,0 +1,124 @@
+/*
+ * Test of SerLCDLinuxSerial pacing in an epoll loop, over a pseudo-terminal.
+ *
+ * A pty takes bytes as fast as they are written, so the test is linked with
+ * -Wl,--wrap=ioctl,--wrap=writev: writes to the port are counted, and
+ * TIOCOUTQ reports what a UART at the port's baud rate would still have to
+ * send. While that is at the pacing cap the loop must sleep on its timer
+ * rather than spin on a port that keeps reporting itself writable.
+ */
+#define _GNU_SOURCE 1
+#include "serLCD_linux_eventloop.h"
+#include "serLCD_linux_serial.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+
+#define BAUD       9600
+#define MAX_QUEUED 16
+
+//The simulated UART behind the port
+static int portFd = -1;
+static double outq = 0;            //Bytes the UART still has to send
+static unsigned long outqTime = 0; //micros() when outq was last brought up to date
+static int overruns = 0;           //Writes that went past the pacing cap
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { if (!(cond)) { printf("  FAILED line %d: %s\n", __LINE__, #cond); failures++; } } while (0)
+
+static void drain() {
+  unsigned long now = micros();
+  outq -= (now - outqTime) * (BAUD / 10.0) / 1000000.0;
+  if (outq < 0) { outq = 0; }
+  outqTime = now;
+}
+
+extern "C" int __real_ioctl(int fd, unsigned long request, ...);
+extern "C" ssize_t __real_writev(int fd, const struct iovec *iov, int count);
+
+extern "C" int __wrap_ioctl(int fd, unsigned long request, ...) {
+  va_list args;
+  va_start(args, request);
+  void *arg = va_arg(args, void *);
+  va_end(args);
+
+  if (fd != portFd || request != TIOCOUTQ) { return __real_ioctl(fd, request, arg); }
+
+  drain();
+  *(int *)arg = (int)(outq + 0.999);
+  return 0;
+}
+
+extern "C" ssize_t __wrap_writev(int fd, const struct iovec *iov, int count) {
+  ssize_t written = __real_writev(fd, iov, count);
+
+  if (fd == portFd && written > 0) {
+    drain();
+    if ((int)(outq + 0.999) + written > MAX_QUEUED) { overruns++; }
+    outq += written;
+  }
+  return written;
+}
+
+int main() {
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  CHECK(master >= 0 && grantpt(master) == 0 && unlockpt(master) == 0);
+
+  SerLCDLinuxSerial port(ptsname(master), B9600);
+  SerLCD lcd;
+  SerLCDEventLoop loop(lcd);
+
+  CHECK(port.open());
+  portFd = port.fd();
+  outqTime = micros();
+  port.setPacing(MAX_QUEUED);
+  CHECK(lcd.begin(port));
+
+  int epollFd = epoll_create1(EPOLL_CLOEXEC);
+  CHECK(epollFd >= 0);
+  CHECK(loop.attach(epollFd));
+
+  //A screen in one transaction, so most of it has to wait for the UART
+  CHECK(lcd.print("0123456789ABCDEFGHIJ0123456789ABCDEFGHIJ0123456789ABCDEFGHIJ0123456789ABCDEFGHIJ") == 80);
+  loop.rearm();
+
+  int wakeups = 0;
+  unsigned long start = millis();
+  while (port.pending() > 0 && millis() - start < 1000) {
+    struct epoll_event events[4];
+    int n = epoll_wait(epollFd, events, 4, 100);
+
+    wakeups++;
+    for (int i = 0; i < n; i++) { CHECK(loop.handle(events[i])); }
+  } // while
+  unsigned long elapsed = millis() - start;
+
+  //The queue empties at the UART's pace, in a handful of wakeups
+  printf("sent in %lu ms with %d wakeups\n", elapsed, wakeups);
+  CHECK(port.pending() == 0);
+  CHECK(overruns == 0);
+  CHECK(wakeups < 40);
+
+  //Everything reached the other end, in order
+  char received[512];
+  int length = 0;
+  fcntl(master, F_SETFL, O_NONBLOCK);
+  for (ssize_t n; (n = read(master, received + length, sizeof(received) - 1 - length)) > 0; ) { length += n; }
+  received[length] = '\0';
+  int rows = 0;
+  for (char *p = received; (p = (char *)memmem(p, received + length - p, "0123456789ABCDEFGHIJ", 20)) != NULL; p += 20) { rows++; }
+  CHECK(rows == MAX_ROWS);
+
+  loop.detach();
+  port.close();
+  close(master);
+  printf(failures ? "%d failures\n" : "passed\n", failures);
+  return failures ? 1 : 0;
+}
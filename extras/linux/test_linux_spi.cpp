@@ -0,0 +1,114 @@
+/*
+ * Test of SerLCDLinuxSPI against a fake spidev node.
+ *
+ * The test is linked with -Wl,--wrap=ioctl, so the transport's ioctl() calls
+ * on the fake node land in __wrap_ioctl() below, which records each
+ * SPI_IOC_MESSAGE the way the kernel would clock it out.
+ */
+#include "serLCD_cI2C.h"
+#include "serLCD_linux_spi.h"
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <linux/spi/spidev.h>
+
+#define MAX_MESSAGES 16
+
+//One SPI_IOC_MESSAGE, chip select held from its first transfer to its last
+struct Message {
+  int transfers;
+  unsigned int leadingDelay; //delay_usecs of an empty first transfer, 0 if there is none
+  int length;
+  uint8_t bytes[LINUX_SPI_BUFFER_SIZE];
+};
+
+//The fake node, which stands in for every descriptor while faking is set
+static bool faking = false;
+static uint8_t mode = 0xFF;
+static uint8_t bits = 0;
+static uint32_t speed = 0;
+static Message messages[MAX_MESSAGES];
+static int messageCount = 0;
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { if (!(cond)) { printf("  FAILED line %d: %s\n", __LINE__, #cond); failures++; } } while (0)
+
+static int record(const struct spi_ioc_transfer *transfer, int count) {
+  if (messageCount == MAX_MESSAGES) { return 0; }
+
+  Message &m = messages[messageCount++];
+  m.transfers = count;
+  m.leadingDelay = (count > 1 && transfer[0].len == 0) ? transfer[0].delay_usecs : 0;
+  m.length = 0;
+  for (int i = 0; i < count; i++) {
+    if (transfer[i].cs_change) { return -1; } //Chip select must stay low for the whole message
+    if (transfer[i].len == 0) { continue; }
+    if (transfer[i].tx_buf == 0 || m.length + transfer[i].len > sizeof(m.bytes)) { return -1; }
+
+    memcpy(&m.bytes[m.length], (const void *)(unsigned long)transfer[i].tx_buf, transfer[i].len);
+    m.length += transfer[i].len;
+  }
+  return m.length;
+}
+
+extern "C" int __real_ioctl(int fd, unsigned long request, ...);
+
+extern "C" int __wrap_ioctl(int fd, unsigned long request, ...) {
+  va_list args;
+  va_start(args, request);
+  void *arg = va_arg(args, void *);
+  va_end(args);
+
+  if (!faking) { return __real_ioctl(fd, request, arg); }
+
+  if (request == SPI_IOC_WR_MODE) { mode = *(uint8_t *)arg; return 0; }
+  if (request == SPI_IOC_WR_BITS_PER_WORD) { bits = *(uint8_t *)arg; return 0; }
+  if (request == SPI_IOC_WR_MAX_SPEED_HZ) { speed = *(uint32_t *)arg; return 0; }
+
+  //SPI_IOC_MESSAGE(n) encodes the size of the transfer array in the request
+  if (_IOC_TYPE(request) == SPI_IOC_MAGIC && _IOC_NR(request) == 0 && _IOC_DIR(request) == _IOC_WRITE &&
+      _IOC_SIZE(request) % sizeof(struct spi_ioc_transfer) == 0)
+  {
+    int n = record((const struct spi_ioc_transfer *)arg, _IOC_SIZE(request) / sizeof(struct spi_ioc_transfer));
+    if (n >= 0) { return n; }
+  }
+
+  errno = EINVAL;
+  return -1;
+}
+
+int main() {
+  SerLCDLinuxSPI bus("/dev/null", 500000);
+  SerLCD lcd;
+  char text[MAX_ROWS * MAX_COLUMNS * 4 + 1];
+
+  faking = true;
+  CHECK(bus.open());
+  CHECK(mode == SPI_MODE_0 && bits == 8 && speed == 500000);
+
+  CHECK(lcd.begin(bus));
+  CHECK(lcd.print("Hi") == 2);
+
+  //A transaction longer than the buffer goes out as several messages
+  memset(text, 'x', sizeof(text) - 1);
+  text[sizeof(text) - 1] = '\0';
+  CHECK(lcd.print(text) == sizeof(text) - 1);
+
+  //init(): display control, entry mode and clear in one message
+  const uint8_t init[] = { SPECIAL_COMMAND, LCD_DISPLAYCONTROL | LCD_DISPLAYON, SPECIAL_COMMAND,
+                           LCD_ENTRYMODESET | LCD_ENTRYLEFT, SETTING_COMMAND, CLEAR_COMMAND };
+  CHECK(messageCount >= 4);
+  CHECK(messages[0].length == 6 && memcmp(messages[0].bytes, init, 6) == 0);
+  CHECK(messages[1].length == 2 && memcmp(messages[1].bytes, "Hi", 2) == 0);
+  CHECK(messages[2].length == LINUX_SPI_BUFFER_SIZE);
+
+  //Every message waits for the display to enable before its first byte
+  for (int i = 0; i < messageCount; i++) {
+    CHECK(messages[i].transfers == 2 && messages[i].leadingDelay == SPI_ENABLE_TIME * 1000U);
+  }
+
+  faking = false;
+  printf(failures ? "%d failures\n" : "passed\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,78 @@
+/*
+ * Test of SerLCDQueue's coalescing: a burst of values for one field leaves
+ * only the newest queued, but an update is never merged past a later one
+ * that overlaps it, so the display ends up as if each had been sent.
+ */
+#include "serLCD_queue.h"
+#include <stdio.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { if (!(cond)) { printf("  FAILED line %d: %s\n", __LINE__, #cond); failures++; } } while (0)
+
+/*
+ * A bus that collects what the display is sent.
+ */
+class RecordingTransport : public SerLCDTransport {
+
+public:
+  char sent[512];
+  int length = 0;
+  virtual bool beginTransmission() { return true; }
+  virtual bool transmit(uint8_t data) {
+    if (length < (int)sizeof(sent) - 1) { sent[length++] = data; sent[length] = '\0'; }
+    return true;
+  }
+  virtual bool endTransmission() { return true; }
+};
+
+static void drain(SerLCD &lcd) {
+  for (int i = 0; i < 200; i++) {
+    lcd.service();
+    delay(1);
+  } // for
+}
+
+static bool shows(SerLCD &lcd, byte row, const char *text) {
+  for (byte col = 0; text[col] != '\0'; col++) {
+    if (lcd.charAt(col, row) != text[col]) { return false; }
+  } // for
+  return true;
+}
+
+int main() {
+  RecordingTransport transport;
+  SerLCD lcd;
+  SerLCDQueue queue;
+  char value[3];
+
+  CHECK(lcd.begin(transport));
+  queue.start(lcd);
+
+  //A later overlapping update keeps the newest one from being merged ahead of it
+  CHECK(queue.post(0, 0, "AAAA"));
+  CHECK(queue.post(2, 0, "BB"));
+  CHECK(queue.post(0, 0, "CCCC"));
+
+  //Shorter text in a field without a width doesn't cover what it would replace
+  CHECK(queue.post(0, 2, "DDDD"));
+  CHECK(queue.post(0, 2, "EE"));
+
+  //A burst for one field is sent once, with its newest value
+  for (int i = 10; i < 20; i++) {
+    snprintf(value, sizeof(value), "%d", i);
+    CHECK(queue.post(0, 1, value, 2));
+  } // for
+
+  drain(lcd);
+
+  CHECK(shows(lcd, 0, "CCCC"));
+  CHECK(shows(lcd, 2, "EEDD"));
+  CHECK(shows(lcd, 1, "19"));
+  CHECK(strstr(transport.sent, "10") == NULL);
+
+  printf(failures ? "%d failures\n" : "passed\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * Test of the non-blocking sequences: the SEQUENCE_* state machine and,
+ * built as C++20, the same steps written as a SerLCDRoutine coroutine. Both
+ * must send the same commands, each only once the display has settled, and
+ * service() must never wait for it.
+ */
+#include "serLCD_sequence.h"
+#include <stdio.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { if (!(cond)) { printf("  FAILED line %d: %s\n", __LINE__, #cond); failures++; } } while (0)
+
+/*
+ * Collects what the display is sent, one transaction after another.
+ */
+class RecordingTransport : public SerLCDTransport {
+
+public:
+  uint8_t sent[256];
+  int length = 0;
+  int transactions = 0;
+  virtual bool beginTransmission() { transactions++; return true; }
+  virtual bool transmit(uint8_t data) {
+    if (length < (int)sizeof(sent)) { sent[length++] = data; }
+    return true;
+  }
+  virtual bool endTransmission() { return true; }
+};
+
+static const byte glyphs[2][8] = {
+  { 0x00, 0x0A, 0x1F, 0x1F, 0x0E, 0x04, 0x00, 0x00 },
+  { 0x04, 0x0E, 0x1F, 0x04, 0x04, 0x04, 0x04, 0x00 },
+};
+
+#ifdef SEQUENCE_COROUTINES
+/*
+ * SerLCDStartSequence as a coroutine.
+ */
+static SerLCDRoutine startRoutine(SerLCD &lcd, unsigned long rgb, const byte (*glyphs)[8], byte glyphCount) {
+  SEQUENCE_CO_SEND(lcd.clear());
+  SEQUENCE_CO_SEND(lcd.setBacklight(rgb));
+
+  for (byte glyph = 0; glyph < glyphCount; glyph++) {
+    SEQUENCE_CO_SEND(lcd.createChar(glyph, glyphs[glyph]));
+  }
+  co_return true;
+}
+#endif
+
+/*
+ * Drive a task to the end through service(), recording the longest call.
+ * Returns the result the task reports.
+ */
+template <typename Task>
+static byte drive(SerLCD &lcd, Task &task, unsigned long *longest) {
+  unsigned long start = millis();
+  *longest = 0;
+
+  task.start(lcd);
+  while (task.running() && millis() - start < 2000) {
+    unsigned long before = micros();
+    lcd.service();
+    if (micros() - before > *longest) { *longest = micros() - before; }
+    delay(1);
+  } // while
+  return task.result();
+}
+
+int main() {
+  RecordingTransport machineBus;
+  SerLCD machineLcd;
+  SerLCDStartSequence sequence(0x00FF00, glyphs, 2);
+  unsigned long longest;
+
+  CHECK(machineLcd.begin(machineBus));
+  machineLcd.deferSettling(true);
+  machineBus.length = 0;
+  machineBus.transactions = 0;
+
+  printf("state machine\n");
+  CHECK(drive(machineLcd, sequence, &longest) == SEQUENCE_DONE);
+  CHECK(machineBus.transactions == 4); //clear, backlight and two glyphs
+  CHECK(longest < 10000); //Shorter than any pause the display needs
+
+#ifdef SEQUENCE_COROUTINES
+  RecordingTransport routineBus;
+  SerLCD routineLcd;
+
+  CHECK(routineLcd.begin(routineBus));
+  routineLcd.deferSettling(true);
+  routineBus.length = 0;
+  routineBus.transactions = 0;
+
+  printf("coroutine\n");
+  SerLCDRoutine routine = startRoutine(routineLcd, 0x00FF00, glyphs, 2);
+  CHECK(routine.result() == SEQUENCE_RUNNING);
+  CHECK(drive(routineLcd, routine, &longest) == SEQUENCE_DONE);
+  CHECK(routineBus.transactions == machineBus.transactions);
+  CHECK(routineBus.length == machineBus.length && memcmp(routineBus.sent, machineBus.sent, machineBus.length) == 0);
+  CHECK(longest < 10000); //Shorter than any pause the display needs
+#endif
+
+  printf(failures ? "%d failures\n" : "passed\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,407 @@
+/*
+ * OpenLCD emulator on a pseudo-terminal, for exercising the serial path of the
+ * SerLCD library on a plain Linux box without hardware.
+ *
+ * The emulator opens a pty and prints the name of its slave side (and can
+ * symlink it to a fixed path). Point SerLCDLinuxSerial, or anything else that
+ * speaks the OpenLCD serial protocol, at that device. The emulator keeps a
+ * virtual 4x20 screen with the HD44780 address layout, shows it in the
+ * terminal, and reports throughput once a second: bytes and updates per
+ * second, and how much of the modelled serial line and controller time the
+ * traffic would use on a real display.
+ *
+ * Build:  make -C extras/linux emulator, or g++ -O2 -o openlcd_emulator openlcd_emulator.cpp
+ * Usage:  openlcd_emulator [-l link] [-b baud] [-q]
+ *   -l link  create a symlink to the pty slave, e.g. /tmp/openlcd
+ *   -b baud  baud rate to model until the stream changes it (default 9600)
+ *   -q       don't draw the screen, only print statistics
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ROWS          4
+#define COLUMNS       20
+#define DDRAM_SIZE    0x80
+
+//OpenLCD command characters
+#define SPECIAL_COMMAND 254
+#define SETTING_COMMAND 0x7C
+
+//Modelled controller time per operation, in microseconds
+#define COST_CHARACTER  50   //Character written to DDRAM
+#define COST_COMMAND    50   //HD44780 instruction
+#define COST_CLEAR      2000 //Clear display / return home
+#define COST_GLYPH      400  //Custom character upload
+#define COST_SETTING    200  //Backlight, contrast and other settings
+
+#define UPDATE_GAP_US   5000 //Idle time that separates one update from the next
+
+//Parser states
+enum State { IDLE, SETTING, SPECIAL, ARGUMENTS };
+
+//Baud rates selected by settings 11 to 23
+static const long baudRates[] = { 2400, 4800, 9600, 14400, 19200, 38400, 57600, 115200,
+                                  230400, 460800, 921600, 1000000, 1200 };
+
+//DDRAM address of the first column of each row
+static const uint8_t rowOffsets[ROWS] = { 0x00, 0x40, 0x14, 0x54 };
+
+struct Emulator {
+  uint8_t ddram[DDRAM_SIZE];
+  uint8_t cgram[8][8];
+  uint8_t address;        //Address counter
+  bool    increment;      //Entry mode: move right after a write
+  bool    displayOn;
+  bool    cursorOn;
+  bool    blinkOn;
+  int     displayShift;   //Columns the view is scrolled by
+  uint8_t red, green, blue;
+  uint8_t contrast;
+  uint8_t i2cAddress;
+  long    baud;
+
+  State   state;
+  uint8_t command;        //Setting whose arguments are being collected
+  uint8_t arguments[8];
+  int     argumentCount;
+  int     argumentsNeeded;
+
+  bool    dirty;          //Screen changed since it was last drawn
+};
+
+//Statistics for the current reporting interval
+struct Stats {
+  unsigned long bytes;
+  unsigned long updates;
+  double wireUs;          //Time the bytes would take on the serial line
+  double controllerUs;    //Time the controller would spend processing them
+  double lastByteUs;      //When the previous byte arrived
+};
+
+static volatile sig_atomic_t running = 1;
+
+static void stop(int) {
+  running = 0;
+}
+
+/*
+ * Monotonic time in microseconds.
+ */
+static double nowUs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/*
+ * Power-on state: blank screen, cursor home, display on.
+ */
+static void reset(Emulator &lcd, long baud) {
+  memset(&lcd, 0, sizeof(lcd));
+  memset(lcd.ddram, ' ', sizeof(lcd.ddram));
+  lcd.increment = true;
+  lcd.displayOn = true;
+  lcd.red = lcd.green = lcd.blue = 255;
+  lcd.contrast = 120;
+  lcd.i2cAddress = 0x72;
+  lcd.baud = baud;
+  lcd.state = IDLE;
+  lcd.dirty = true;
+}
+
+/*
+ * Move the address counter one step the way the HD44780 does in 2-line mode:
+ * 0x00-0x27 and 0x40-0x67, each running into the other.
+ */
+static void stepAddress(Emulator &lcd, bool forward) {
+  if (forward) {
+    if      (lcd.address == 0x27) { lcd.address = 0x40; }
+    else if (lcd.address == 0x67) { lcd.address = 0x00; }
+    else                          { lcd.address = (lcd.address + 1) & 0x7F; }
+  }
+  else {
+    if      (lcd.address == 0x40) { lcd.address = 0x27; }
+    else if (lcd.address == 0x00) { lcd.address = 0x67; }
+    else                          { lcd.address = (lcd.address - 1) & 0x7F; }
+  }
+}
+
+/*
+ * Put a character at the address counter.
+ */
+static double writeCharacter(Emulator &lcd, uint8_t c) {
+  lcd.ddram[lcd.address] = c;
+  stepAddress(lcd, lcd.increment);
+  lcd.dirty = true;
+  return COST_CHARACTER;
+}
+
+/*
+ * Carry out an HD44780 instruction sent after the special command prefix.
+ */
+static double instruction(Emulator &lcd, uint8_t c) {
+  if (c & 0x80) {                 //Set DDRAM address
+    lcd.address = c & 0x7F;
+  }
+  else if (c & 0x40) {            //Set CGRAM address, not modelled
+  }
+  else if (c & 0x20) {            //Function set, not modelled
+  }
+  else if (c & 0x10) {            //Cursor or display shift
+    bool right = c & 0x04;
+    if (c & 0x08) { lcd.displayShift += right ? 1 : -1; lcd.dirty = true; }
+    else          { stepAddress(lcd, right); }
+  }
+  else if (c & 0x08) {            //Display on/off control
+    lcd.displayOn = c & 0x04;
+    lcd.cursorOn  = c & 0x02;
+    lcd.blinkOn   = c & 0x01;
+    lcd.dirty = true;
+  }
+  else if (c & 0x04) {            //Entry mode set
+    lcd.increment = c & 0x02;
+  }
+  else if (c & 0x02) {            //Return home
+    lcd.address = 0;
+    lcd.displayShift = 0;
+    lcd.dirty = true;
+    return COST_CLEAR;
+  }
+  else if (c & 0x01) {            //Clear display
+    memset(lcd.ddram, ' ', sizeof(lcd.ddram));
+    lcd.address = 0;
+    lcd.displayShift = 0;
+    lcd.dirty = true;
+    return COST_CLEAR;
+  }
+  return COST_COMMAND;
+}
+
+/*
+ * Number of argument bytes that follow a setting command.
+ */
+static int settingArguments(uint8_t c) {
+  if (c == 0x18 || c == 0x19) { return 1; } //Contrast, TWI address
+  if (c == 0x2B)              { return 3; } //RGB backlight
+  if (c >= 27 && c <= 34)     { return 8; } //Create custom character
+  return 0;
+}
+
+/*
+ * Carry out a setting command once all its arguments have arrived.
+ */
+static double setting(Emulator &lcd, uint8_t c, const uint8_t *args) {
+  if (c == 0x2D) {                                //Clear display and home
+    memset(lcd.ddram, ' ', sizeof(lcd.ddram));
+    lcd.address = 0;
+    lcd.displayShift = 0;
+    lcd.dirty = true;
+    return COST_CLEAR;
+  }
+  if (c >= 11 && c <= 23) {                       //Baud rate
+    lcd.baud = baudRates[c - 11];
+    fprintf(stderr, "baud rate changed to %ld\n", lcd.baud);
+  }
+  else if (c == 0x18) { lcd.contrast = args[0]; }
+  else if (c == 0x19) { lcd.i2cAddress = args[0]; }
+  else if (c == 0x2B) {
+    lcd.red = args[0];
+    lcd.green = args[1];
+    lcd.blue = args[2];
+    lcd.dirty = true;
+  }
+  else if (c >= 27 && c <= 34) {                  //Create custom character
+    memcpy(lcd.cgram[c - 27], args, 8);
+    lcd.dirty = true;
+    return COST_GLYPH;
+  }
+  else if (c >= 35 && c <= 42) {                  //Write custom character
+    return writeCharacter(lcd, c - 35);
+  }
+  else if (c >= 128 && c <= 157) { lcd.red   = (c - 128) * 255 / 29; lcd.dirty = true; }
+  else if (c >= 158 && c <= 187) { lcd.green = (c - 158) * 255 / 29; lcd.dirty = true; }
+  else if (c >= 188 && c <= 217) { lcd.blue  = (c - 188) * 255 / 29; lcd.dirty = true; }
+  else if (c == 8) {                              //Software reset
+    reset(lcd, lcd.baud);
+  }
+  return COST_SETTING;
+}
+
+/*
+ * Feed one received byte through the protocol parser.
+ *
+ * returns: modelled controller time for the byte in microseconds.
+ */
+static double receive(Emulator &lcd, uint8_t c) {
+  switch (lcd.state) {
+    case IDLE:
+      if (c == SETTING_COMMAND) { lcd.state = SETTING; return 0; }
+      if (c == SPECIAL_COMMAND) { lcd.state = SPECIAL; return 0; }
+      return writeCharacter(lcd, c);
+
+    case SPECIAL:
+      lcd.state = IDLE;
+      return instruction(lcd, c);
+
+    case SETTING:
+      lcd.command = c;
+      lcd.argumentCount = 0;
+      lcd.argumentsNeeded = settingArguments(c);
+      if (lcd.argumentsNeeded > 0) { lcd.state = ARGUMENTS; return 0; }
+      lcd.state = IDLE;
+      return setting(lcd, c, lcd.arguments);
+
+    case ARGUMENTS:
+      lcd.arguments[lcd.argumentCount++] = c;
+      if (lcd.argumentCount < lcd.argumentsNeeded) { return 0; }
+      lcd.state = IDLE;
+      return setting(lcd, lcd.command, lcd.arguments);
+  }
+  return 0;
+}
+
+/*
+ * Draw the visible screen. Custom characters show as their slot number.
+ */
+static void draw(const Emulator &lcd) {
+  printf("\033[H\033[2J");
+  printf("+--------------------+  backlight %3d,%3d,%3d  contrast %3d\n",
+         lcd.red, lcd.green, lcd.blue, lcd.contrast);
+
+  for (int row = 0; row < ROWS; row++) {
+    putchar('|');
+    for (int col = 0; col < COLUMNS; col++) {
+      int offset = ((col + lcd.displayShift) % 40 + 40) % 40;
+      uint8_t c = lcd.ddram[(rowOffsets[row] & 0x40) + ((rowOffsets[row] & 0x3F) + offset) % 40];
+
+      if (!lcd.displayOn)   { c = ' '; }
+      else if (c < 8)       { c = '0' + c; }
+      else if (c < 32 || c > 126) { c = '?'; }
+      putchar(c);
+    }
+    puts("|");
+  }
+
+  printf("+--------------------+  %s%s%s  %ld baud\n",
+         lcd.displayOn ? "display " : "off     ",
+         lcd.cursorOn ? "cursor " : "",
+         lcd.blinkOn ? "blink" : "", lcd.baud);
+  fflush(stdout);
+}
+
+/*
+ * Open the master side of a new pty and put the slave in raw mode.
+ *
+ * returns: the master fd, or -1 on error. slave receives the slave fd,
+ *          which is kept open so the master doesn't see hangups between clients.
+ */
+static int openPty(int &slave) {
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0) { return -1; }
+
+  slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+  if (slave < 0) { return -1; }
+
+  struct termios tty;
+  tcgetattr(slave, &tty);
+  cfmakeraw(&tty);
+  tcsetattr(slave, TCSANOW, &tty);
+  return master;
+}
+
+int main(int argc, char **argv) {
+  const char *link = NULL;
+  long baud = 9600;
+  bool quiet = false;
+  int option;
+
+  while ((option = getopt(argc, argv, "l:b:q")) != -1) {
+    switch (option) {
+      case 'l': link = optarg; break;
+      case 'b': baud = atol(optarg); break;
+      case 'q': quiet = true; break;
+      default:
+        fprintf(stderr, "usage: %s [-l link] [-b baud] [-q]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  int slave;
+  int master = openPty(slave);
+  if (master < 0) {
+    perror("pty");
+    return 1;
+  }
+
+  const char *name = ptsname(master);
+  if (link != NULL) {
+    unlink(link);
+    if (symlink(name, link) < 0) { perror("symlink"); }
+  }
+  fprintf(stderr, "OpenLCD emulator listening on %s%s%s\n", name, link ? " -> " : "", link ? link : "");
+
+  signal(SIGINT, stop);
+  signal(SIGTERM, stop);
+
+  Emulator lcd;
+  reset(lcd, baud);
+  Stats stats;
+  memset(&stats, 0, sizeof(stats));
+  double reportAt = nowUs() + 1e6;
+  double drawnAt = 0;
+
+  while (running) {
+    struct pollfd pfd = { master, POLLIN, 0 };
+    int ready = poll(&pfd, 1, 50);
+    if (ready < 0 && errno != EINTR) { break; }
+
+    double now = nowUs();
+    if (ready > 0 && (pfd.revents & POLLIN)) {
+      uint8_t buffer[512];
+      ssize_t n = read(master, buffer, sizeof(buffer));
+
+      for (ssize_t i = 0; i < n; i++) {
+        //A pause on the line marks the start of a new update
+        if (now - stats.lastByteUs >= UPDATE_GAP_US) { stats.updates++; }
+        stats.lastByteUs = now;
+
+        stats.bytes++;
+        stats.wireUs += 10e6 / lcd.baud; //start, 8 data and stop bits
+        stats.controllerUs += receive(lcd, buffer[i]);
+      }
+    }
+
+    if (!quiet && lcd.dirty && now - drawnAt >= 50000) {
+      draw(lcd);
+      lcd.dirty = false;
+      drawnAt = now;
+    }
+
+    if (now >= reportAt) {
+      double elapsed = now - (reportAt - 1e6);
+      fprintf(stderr, "%6lu B/s  %4lu updates/s  line %5.1f%%  controller %5.1f%%%s\n",
+              stats.bytes, stats.updates,
+              100.0 * stats.wireUs / elapsed, 100.0 * stats.controllerUs / elapsed,
+              (stats.wireUs > elapsed || stats.controllerUs > elapsed) ? "  (a real display would fall behind)" : "");
+
+      double lastByteUs = stats.lastByteUs;
+      memset(&stats, 0, sizeof(stats));
+      stats.lastByteUs = lastByteUs;
+      reportAt = now + 1e6;
+    }
+  }
+
+  if (link != NULL) { unlink(link); }
+  close(slave);
+  close(master);
+  return 0;
+}
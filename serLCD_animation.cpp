@@ -0,0 +1,60 @@
+/*
+ * Custom character animation for the SerLCD.
+ *
+ * Usage:
+ *   const byte spinner[4][8] = { ... };
+ *   SerLCDAnimation busy(0, spinner, 4, 150);
+ *   busy.start(lcd);
+ *   lcd.setCursor(19, 0);
+ *   lcd.writeChar(busy.location()); //Place the glyph in as many cells as needed
+ *   ...
+ *   loop() { lcd.service(); }
+ */
+#include "serLCD_animation.h"
+
+/*
+ * byte         location      - CGRAM slot 0 to 7 to animate
+ * byte[][8]    frames        - glyph bitmaps, one per frame
+ * byte         frameCount    - number of frames
+ * unsigned int frameInterval - time between frames in ms
+ */
+SerLCDAnimation::SerLCDAnimation(byte location, const byte (*frames)[8], byte frameCount, unsigned int frameInterval)
+  : _location(location & 0x7), _frames(frames), _frameCount(frameCount), _frameInterval(frameInterval) {
+}
+
+/*
+ * Attach the animation to a display and upload the first frame on the next service().
+ * Turns on deferred settling, so service() doesn't wait out the pause after each upload.
+ */
+void SerLCDAnimation::start(SerLCD &lcd) {
+  _frame = 0;
+  lcd.deferSettling(true);
+  lcd.attach(*this);
+  schedule(millis());
+} // start
+
+/*
+ * Freeze the animation on its current frame.
+ */
+void SerLCDAnimation::stop() {
+  unschedule();
+} // stop
+
+/*
+ * Upload the next frame and schedule the one after it.
+ */
+bool SerLCDAnimation::run(SerLCD &lcd, unsigned long now) {
+  if (_frameCount == 0) { return true; }
+
+  //Keep a steady frame rate, but don't try to catch up after a long stall
+  unsigned long next = due() + _frameInterval;
+  if ((long)(now - next) >= 0) { next = now + _frameInterval; }
+  schedule(next);
+
+  if (lcd.createChar(_location, _frames[_frame]))
+  {
+    _frame = (_frame + 1) % _frameCount;
+    return true;
+  }
+  else { return false; }
+} // run
@@ -0,0 +1,28 @@
+#ifndef SER_LCD_ANIMATION_H
+#define SER_LCD_ANIMATION_H
+
+#include "serLCD_cI2C.h"
+
+/*
+ * Animates a custom character by redefining its CGRAM slot on a timer.
+ * Every cell showing the glyph (placed with writeChar()) changes at once, so a
+ * frame costs a single 10-byte glyph upload no matter how many cells show it.
+ */
+class SerLCDAnimation : public SerLCDTask {
+
+public:
+  SerLCDAnimation(byte location, const byte (*frames)[8], byte frameCount, unsigned int frameInterval);
+  void start(SerLCD &lcd);
+  void stop();
+  byte location() const { return _location; }
+  virtual bool run(SerLCD &lcd, unsigned long now);
+  virtual byte cost() const { return 10; } //Setting command, slot and 8 bitmap bytes
+private:
+  byte _location;             //CGRAM slot 0 to 7 that is redefined
+  const byte (*_frames)[8];   //Glyph bitmaps, one 8-byte charmap per frame
+  byte _frameCount;
+  byte _frame = 0;            //Next frame to upload
+  unsigned int _frameInterval; //Time between frames in ms
+};
+
+#endif
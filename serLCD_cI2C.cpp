@@ -10,6 +10,17 @@
  *    the Print class in the core AVR library (C:\Program Files (x86)\Arduino\hardware\arduino\avr\cores\arduino).
  *    The characters will be printed out to the right of the cursor position.
  * 3) At any time, the entire screen can be cleared using clear().
+ * 4) '\n', '\r', '\b', '\t' and '\f' (clear) move the cursor like a terminal, so println() starts a new row.
+ *    The cursor is tracked by the library and only sent to the display along with the next character.
+ *    Text running past the end of a row continues on the row below (see noLineWrap()).
+ * 5) printf() and printf_P() format straight into the transmission, without a buffer or String.
+ * 6) The pauses the display needs after a command are normally spent in delay(). After deferSettling(true) they
+ *    are only recorded; check ready() (or let service() and SerLCDSequence do it) before sending more.
+ * 7) Periodic work such as animations is attached as a SerLCDTask and driven by calling service() from loop().
+ * 8) Displays behind a TCA9548A mux share one SerLCDMux; the channel is only switched when a different display
+ *    is addressed, so consecutive writes to the same display cost no extra bus traffic.
+ * 9) Many displays, possibly on several buses, are driven together through a SerLCDGroup.
+ * 10) SerLCDTiledDisplay joins several displays into one larger virtual screen.
  *
  * Updating via cursor position allows focused updates on only certain parts of the screen, instead of clearing the
  * entire screen before each update.
@@ -96,15 +107,24 @@
  *		For example, to change the baud rate to 115200 send 124 followed by 18.
  *
  */
-#include "SerLCD_cI2C.h"
+#include "serLCD_cI2C.h"
+
+//DDRAM address of the first column of each row
+static const byte rowOffsets[MAX_ROWS] = { 0x00, 0x40, 0x14, 0x54 };
+
+//Order in which the controller's address counter runs through the rows
+static const byte nextRow[MAX_ROWS] = { 2, 3, 1, 0 };
+static const byte prevRow[MAX_ROWS] = { 3, 2, 0, 1 };
 
 //<<constructor>> setup using defaults
 SerLCD::SerLCD(){
+  resetFrame();
 }
 
 //<<destructor>>
 SerLCD::~SerLCD(){/*nothing to destruct*/}
 
+#ifdef ARDUINO
 /*
  * Set up the i2c communication with the SerLCD.
  * wirePort - TwoWire port
@@ -116,6 +136,21 @@ void SerLCD::begin(I2C &wirePort, byte i2c_addr) {
   begin(wirePort);
 } // begin
 
+/*
+ * Set up the i2c communication with a SerLCD behind a TCA9548A multiplexer.
+ * wirePort - I2C port
+ * i2c_addr - I2C address
+ * mux      - the multiplexer, shared by all displays behind it
+ * channel  - mux channel 0 to 7 the display is on
+ */
+bool SerLCD::begin(I2C &wirePort, byte i2c_addr, SerLCDMux &mux, byte channel) {
+  _i2cAddr    = i2c_addr;
+  _mux        = &mux;
+  _muxChannel = channel;
+
+  return begin(wirePort);
+} // begin
+
 /*
  * Set up the i2c communication with the SerLCD.
  */
@@ -123,6 +158,7 @@ bool SerLCD::begin(I2C &wirePort) {
   _i2cPort = &wirePort; //Grab which port the user wants us to use
   _serialPort = NULL; //Set to null to be safe
   _spiPort = NULL;    //Set to null to be safe
+  _transport = NULL;  //Set to null to be safe
 
   //User must initialize I2C before this function is called.
 
@@ -137,6 +173,7 @@ void SerLCD::begin(Stream &serialPort) {
   _serialPort = &serialPort; //Grab which port the user wants us to use
   _i2cPort = NULL; //Set to null to be safe
   _spiPort = NULL; //Set to null to be safe
+  _transport = NULL; //Set to null to be safe
 
   //Call init function since display may have been left in unknown state
   init();
@@ -171,6 +208,7 @@ void SerLCD::begin(SPIClass &spiPort, byte csPin) {
   _spiPort = &spiPort; //Grab the port the user wants us to use
   _i2cPort = NULL; //Set to null to be safe
   _serialPort = NULL; //Set to null to be safe
+  _transport = NULL; //Set to null to be safe
 
   _spiPort->begin(); //call begin, in case the user forgot
 
@@ -178,13 +216,71 @@ void SerLCD::begin(SPIClass &spiPort, byte csPin) {
   init();
 } // begin
 
+#endif // ARDUINO
+
+/*
+ * Set up communication with the SerLCD through a user supplied transport.
+ */
+bool SerLCD::begin(SerLCDTransport &transport) {
+  _transport = &transport; //Grab the connection the user wants us to use
+#ifdef ARDUINO
+  _i2cPort = NULL;    //Set to null to be safe
+  _serialPort = NULL; //Set to null to be safe
+  _spiPort = NULL;    //Set to null to be safe
+#endif
+
+  //Call init function since display may have been left in unknown state
+  return init();
+} // begin
+
+/*
+ * Share the bus with other devices. Transmissions are split into chunks of
+ * at most chunkSize bytes; the arbiter is asked for the bus before each chunk
+ * and told when it is free again, so other traffic on the bus can go
+ * between chunks instead of waiting for a whole frame. The display treats
+ * the chunks as one stream. Pass NULL to stop sharing.
+ *
+ * arbiter   - decides when the display may use the bus
+ * chunkSize - largest number of bytes sent in one go
+ */
+void SerLCD::setArbiter(SerLCDBusArbiter *arbiter, byte chunkSize) {
+  _arbiter = arbiter;
+  _chunkSize = max(1, chunkSize);
+} // setArbiter
+
 //private functions for serial transmission
 /*
  * Begin transmission to the device
  */
 bool SerLCD::beginTransmission() {
+  waitReady(); //only waits if a caller didn't check ready() after deferSettling()
+
+  if (_arbiter && !_arbiter->acquire()) { return false; }
+  _chunkBytes = 0;
+  _txBytes = 0;
+
+  if (openPort()) {
+    _txOpen = true;
+    return true;
+  }
+  else {
+    if (_arbiter) { _arbiter->release(); }
+    return false;
+  }
+} //beginTransmission
+
+/*
+ * Start a transmission on whichever port is in use
+ */
+bool SerLCD::openPort() {
+  if (_transport) { return _transport->beginTransmission(); }
+
+#ifdef ARDUINO
 	//do nothing if using serialPort
 	if (_i2cPort) {
+    //Switch the mux over only if another channel was used last
+    if (_mux && !_mux->select(*_i2cPort, _muxChannel)) { return false; }
+
     if (_i2cPort->beginTransmission(_i2cAddr, true, false) == I2C_STATUS_OK) { return true; }
     else { return false; }
 	} else if (_spiPort) {
@@ -193,49 +289,117 @@ bool SerLCD::beginTransmission() {
 			_spiPort->beginTransaction(_spiSettings); //gain control of the SPI bus
 		} //if _spiSettings
 #endif
-		digitalWrite(_csPin, LOW);
-		delay(10); //wait a bit for display to enable
+    //service() normally selects the display ahead of time, see selectAhead()
+    if (!_spiSelected) {
+		  digitalWrite(_csPin, LOW);
+		  delay(SPI_ENABLE_TIME); //wait a bit for display to enable
+    }
+    _spiSelected = true;
     return true;
 	}  // if-else
-} //beginTransmission
+
+  return (_serialPort != NULL);
+#else
+  return false;
+#endif
+} //openPort
 
 /*
- * Send data to the device
+ * Send data to the device. If the byte can't be sent the transmission is
+ * ended right away, so the port is closed and a shared bus released even
+ * though the caller then skips endTransmission().
  *
  * data - byte to send
  */
 bool SerLCD::transmit(byte data) {
-   if (_i2cPort) {
-   		if (_i2cPort->transmit(data) == I2C_STATUS_OK) { return true; }
-      else { return false; }
+   if (!_txOpen) { return false; } //An earlier byte of this transmission failed
+
+   //End the chunk and let other devices have the bus before going on
+   if (_arbiter && _chunkBytes == _chunkSize) {
+     bool closed = closePort();
+     _arbiter->release();
+     _txOpen = false;
+     if (!closed) { return false; }
+
+     //Part of a command may be out already, so wait for the bus rather than give up
+     while (!_arbiter->acquire()) { }
+     if (!openPort()) {
+       _arbiter->release();
+       return false;
+     }
+     _txOpen = true;
+     _chunkBytes = 0;
+   }
+   _chunkBytes++;
+   _txBytes++;
+
+   bool ok = false;
+   if (_transport) {
+   	   ok = _transport->transmit(data);
+   }
+#ifdef ARDUINO
+   else if (_i2cPort) {
+   		ok = (_i2cPort->transmit(data) == I2C_STATUS_OK);
    	} else if (_serialPort){
    		_serialPort->write(data);
-      return true;
+      ok = true;
    	} else if (_spiPort) {
    	   _spiPort->transfer(data);
-       return true;
+       ok = true;
 	}  // if-else
+#endif
+
+  if (!ok) { endTransmission(); } //Give up the port and the bus
+  return ok;
  } //transmit
 
 /*
- * Begin transmission to the device
+ * End transmission to the device
  */
 bool SerLCD::endTransmission() {
+  if (!_txOpen) { return false; } //Already ended when a byte failed
+
+  bool ok = closePort();
+  _txOpen = false;
+
+  if (_arbiter) { _arbiter->release(); }
+
+  //Pay for the bus time used; ready() stays false while in debt
+  if (_busShare < 100) {
+    _tokens = tokens() - (long)busTime(_txBytes);
+    _tokenTime = millis();
+  }
+  return ok;
+} //endTransmission
+
+/*
+ * End the transmission on whichever port is in use
+ */
+bool SerLCD::closePort() {
+  if (_transport) { return _transport->endTransmission(); }
+
+#ifdef ARDUINO
 	//do nothing if using Serial port
 	if (_i2cPort) {
 		if (_i2cPort->endTransmission() == I2C_STATUS_OK) { return true; }
     else { return false; }
 	} else if (_spiPort) {
 		digitalWrite(_csPin, HIGH);  //disable display
+    _spiSelected = false;
 #ifdef SPI_HAS_TRANSACTION
         if (_spiTransaction) {
 			_spiPort->endTransaction(); //let go of the SPI bus
 		} //if _spiSettings
 #endif
-		delay(10); //wait a bit for display to disable
+		settle(10); //wait a bit for display to disable
     return true;
 	}  // if-else
-} //beginTransmission
+
+  return (_serialPort != NULL);
+#else
+  return false;
+#endif
+} //closePort
 
 /*
  * Initialize the display
@@ -251,7 +415,8 @@ bool SerLCD::init() {
     transmit(CLEAR_COMMAND) &&                        //Send clear display command
     endTransmission())                                //Stop transmission
   {
-    delay(50); //let things settle a bitreturn true;
+    resetFrame();
+    settle(50); //let things settle a bit
     return true;
   }
   else { return false; }
@@ -269,7 +434,7 @@ bool SerLCD::init() {
      transmit(command) &&         //Send the command code
      endTransmission())           //Stop transmission
    {
-     delay(10); //Hang out for a bit
+     settle(10); //Hang out for a bit
      return true;
    }
    else { return false; }
@@ -286,7 +451,7 @@ bool SerLCD::specialCommand(byte command) {
     transmit(command) &&          //Send the command code
     endTransmission())            //Stop transmission
   {
-    delay(50); //Wait a bit longer for special display commands
+    settle(50); //Wait a bit longer for special display commands
     return true;
   }
   else { return false; }
@@ -312,7 +477,7 @@ bool SerLCD::specialCommand(byte command, byte count) {
     
     if (endTransmission()) //Stop transmission
     {
-      delay(50); //Wait a bit longer for special display commands
+      settle(50); //Wait a bit longer for special display commands
       return true;
     }
     else { return false; }
@@ -328,7 +493,8 @@ bool SerLCD::specialCommand(byte command, byte count) {
 bool SerLCD::clear() {
   if (command(CLEAR_COMMAND))
   {
-    delay(10);  // a little extra delay after clear
+    resetFrame();
+    settle(10);  // a little extra delay after clear
     return true;
   }
   else { return false; }
@@ -340,26 +506,41 @@ bool SerLCD::clear() {
  * the display.
  */
 bool SerLCD::home() {
-  return specialCommand(LCD_RETURNHOME);
+  if (specialCommand(LCD_RETURNHOME))
+  {
+    _col = 0;
+    _row = 0;
+    _cursorPending = false;
+    _wrapPending = false;
+    return true;
+  }
+  else { return false; }
 }
 
 /*
  * Set the cursor position to a particular column and row.
  *
- * column - byte 0 to 19
+ * column - byte 0 to 19; larger columns are passed through to reach DDRAM
+ *          past the visible row, e.g. on a shifted display. Text written
+ *          there is not tracked (see charAt()).
  * row - byte 0 to 3
  *
  * returns: boolean true if cursor set.
  */
 bool SerLCD::setCursor(byte col, byte row) {
-  int row_offsets[] = { 0x00, 0x40, 0x14, 0x54 };
-
   //kepp variables in bounds
-  row = max(0, row);      //row cannot be less than 0
   row = min(row, MAX_ROWS-1); //row cannot be greater than max rows
 
   //send the command
-  return specialCommand(LCD_SETDDRAMADDR | (col + row_offsets[row]));
+  if (specialCommand(LCD_SETDDRAMADDR | ddramAddress(col, row)))
+  {
+    _col = col;
+    _row = row;
+    _cursorPending = false;
+    _wrapPending = false;
+    return true;
+  }
+  else { return false; }
 } // setCursor
 
 /*
@@ -367,7 +548,7 @@ bool SerLCD::setCursor(byte col, byte row) {
  * byte   location - character number 0 to 7
  * byte[] charmap  - byte array for character
  */
-bool SerLCD::createChar(byte location, byte charmap[]) {
+bool SerLCD::createChar(byte location, const byte charmap[]) {
   location &= 0x7; // we only have 8 locations 0-7
   
   if (beginTransmission())
@@ -383,7 +564,7 @@ bool SerLCD::createChar(byte location, byte charmap[]) {
 
       if (endTransmission())
       {
-        delay(50);  //This takes a bit longer
+        settle(50);  //This takes a bit longer
         return true;
       }
       else { return false; }
@@ -394,43 +575,462 @@ bool SerLCD::createChar(byte location, byte charmap[]) {
 }
 
 /*
- * Write a customer character to the display
+ * Write a customer character to the display, in one transmission with the
+ * tracked cursor address if that is pending.
  *
  * byte location - character number 0 to 7
  */
 bool SerLCD::writeChar(byte location) {
   location &= 0x7; // we only have 8 locations 0-7
 
-  return command(35 + location);
+  wrapLine();
+  if (beginTransmission() &&      // transmit to device
+    transmitCursor() &&           //Move to the tracked cursor if needed
+    transmit(SETTING_COMMAND) &&  //Put LCD into setting mode
+    transmit(35 + location) &&    //Write the custom character
+    endTransmission())            //Stop transmission
+  {
+    settle(10); //Hang out for a bit
+    if (_col < MAX_COLUMNS) { _frame[_row][_col] = location; }
+    advanceCursor();
+    return true;
+  }
+  else { return false; }
 }
 
+/*
+ * Write a character to a cell and leave the display's cursor on that cell,
+ * all in one transmission, e.g. for an editor that shows the underline or
+ * blink cursor on the character being changed.
+ *
+ * column - byte 0 to 19
+ * row - byte 0 to 3
+ * c - character to show
+ */
+bool SerLCD::overwrite(byte col, byte row, byte c) {
+  if (col >= MAX_COLUMNS || row >= MAX_ROWS) { return false; }
+
+  byte address = LCD_SETDDRAMADDR | ddramAddress(col, row);
+  if (beginTransmission() &&      // transmit to device
+    transmit(SPECIAL_COMMAND) &&  //Send special command character
+    transmit(address) &&          //Move to the cell
+    transmit(c) &&                //Write the character, which moves the cursor on
+    transmit(SPECIAL_COMMAND) &&  //Send special command character
+    transmit(address) &&          //Move back onto the cell
+    endTransmission())            //Stop transmission
+  {
+    settle(50); //Wait a bit longer for special display commands
+    _frame[row][col] = c;
+    _col = col;
+    _row = row;
+    _cursorPending = false;
+    _wrapPending = false;
+    return true;
+  }
+  else { return false; }
+} // overwrite
+
 /*
  * Write a byte to the display.
  * Required for Print.
  */
 size_t SerLCD::write(uint8_t b) {
-  beginTransmission(); // transmit to device
-  transmit(b);
-  endTransmission(); //Stop transmission
-  delay(10); // wait a bit
+  return write(&b, 1);
  } // write
 
  /*
  * Write a character buffer to the display.
  * Required for Print.
+ * A buffer that only moves the tracked cursor, like the "\r\n" of
+ * println(), sends nothing; the move goes out with the next text.
  */
 size_t SerLCD::write(const uint8_t *buffer, size_t size) {
   size_t n = 0;
-  beginTransmission(); // transmit to device
+  bool sending = false;
 	while (size--) {
-	  transmit(*buffer++);
+	  byte c = *buffer++;
+	  if (!sending && !movesCursorOnly(c)) {
+	    if (!beginTransmission()) { break; } // transmit to device
+	    sending = true;
+	  }
+	  if (!put(c)) { break; }
 	  n++;
 	} //while
-  endTransmission(); //Stop transmission
-  delay(10); //
+  if (sending) {
+    if (!endTransmission()) { return 0; } //Stop transmission
+    settle(10); //
+  }
   return n;
 } //write
 
+/*
+ * Whether put() handles a character by only moving the tracked cursor.
+ */
+bool SerLCD::movesCursorOnly(byte c) {
+  return c == '\n' || c == '\r' || c == '\b' || c == '\t';
+} // movesCursorOnly
+
+/*
+ * Print formatted text to the display, like the C function of the same name.
+ * Control characters are handled as in write(). At most one screen of
+ * characters is sent.
+ *
+ * returns: the number of characters sent.
+ */
+size_t SerLCD::printf(const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  size_t n = vformat(format, args, false);
+  va_end(args);
+  return n;
+} // printf
+
+/*
+ * Same as printf(), with the format string kept in program memory,
+ * e.g. lcd.printf_P(PSTR("%3d%%"), level);
+ */
+size_t SerLCD::printf_P(PGM_P format, ...) {
+  va_list args;
+  va_start(args, format);
+  size_t n = vformat(format, args, true);
+  va_end(args);
+  return n;
+} // printf_P
+
+//Where formatted output goes while it is being generated
+struct FormatSink {
+  SerLCD *lcd;
+  size_t count;
+  bool ok;
+};
+
+#ifdef __AVR__
+/*
+ * avr-libc stream callback, sends each formatted character as it is produced.
+ */
+int SerLCD::formatPut(char c, FILE *stream) {
+  FormatSink *sink = (FormatSink *)fdev_get_udata(stream);
+
+  if (sink->ok && sink->count < MAX_ROWS * MAX_COLUMNS) {
+    sink->ok = sink->lcd->put(c);
+    if (sink->ok) { sink->count++; }
+  }
+  return 0;
+} // formatPut
+#endif
+
+/*
+ * Format text into a single transmission. On AVR the characters go straight
+ * from vfprintf to the bus; elsewhere they are formatted into a buffer of
+ * one screen first.
+ */
+size_t SerLCD::vformat(const char *format, va_list args, bool progmem) {
+  FormatSink sink = { this, 0, true };
+
+  if (format == NULL || !beginTransmission()) { return 0; } // transmit to device
+
+#ifdef __AVR__
+  FILE stream;
+  fdev_setup_stream(&stream, formatPut, NULL, _FDEV_SETUP_WRITE);
+  fdev_set_udata(&stream, &sink);
+  if (progmem) { vfprintf_P(&stream, format, args); }
+  else         { vfprintf(&stream, format, args); }
+#else
+  (void)progmem; //program memory is ordinary memory here
+  char text[MAX_ROWS * MAX_COLUMNS + 1];
+  vsnprintf(text, sizeof(text), format, args);
+  for (const char *p = text; *p != '\0' && sink.ok; p++) {
+    sink.ok = put(*p);
+    if (sink.ok) { sink.count++; }
+  } // for
+#endif
+
+  if (!endTransmission()) { return 0; } //Stop transmission
+  settle(10);
+  return sink.count;
+} // vformat
+
+/*
+ * Send one character of text as part of an ongoing transmission.
+ * Control characters move the tracked cursor instead of being sent;
+ * the new position is only sent to the display ahead of the next
+ * printable character, so "\r\n" costs a single address command.
+ *
+ * '\n' - start of the next row
+ * '\r' - start of the current row
+ * '\b' - one column back, without erasing
+ * '\t' - next tab stop in the row
+ * '\f' - clear the display
+ *
+ * After the last column of a row the cursor stays there until the next
+ * printable character (see advanceCursor()), so a control character acts
+ * on the row just written: "\r\n" after a full row starts the row below.
+ */
+bool SerLCD::put(byte c) {
+  switch (c) {
+    case '\n':
+      _row = (_row + 1) % MAX_ROWS;
+      _col = 0;
+      _cursorPending = true;
+      _wrapPending = false;
+      return true;
+    case '\r':
+      _col = 0;
+      _cursorPending = true;
+      _wrapPending = false;
+      return true;
+    case '\b':
+      if (_wrapPending) { _wrapPending = false; } //Back onto the last column
+      else if (_col > 0) {
+        _col--;
+        _cursorPending = true;
+      }
+      return true;
+    case '\t':
+      _col = min((_col / TAB_WIDTH + 1) * TAB_WIDTH, MAX_COLUMNS - 1);
+      _cursorPending = true;
+      _wrapPending = false;
+      return true;
+    case '\f':
+      if (transmit(SETTING_COMMAND) && //Put LCD into setting mode
+          transmit(CLEAR_COMMAND))     //Send clear display command
+      {
+        resetFrame();
+        return true;
+      }
+      else { return false; }
+  } // switch
+
+  return putText(c);
+} // put
+
+/*
+ * Send one character to the tracked cursor as part of an ongoing transmission,
+ * preceded by the cursor address if it is pending.
+ */
+bool SerLCD::putText(byte c) {
+  wrapLine();
+  if (!transmitCursor() || !transmit(c)) { return false; }
+
+  if (_col < MAX_COLUMNS) { _frame[_row][_col] = c; }
+  advanceCursor();
+  return true;
+} // putText
+
+/*
+ * Show text in a field of a row, sending only the cells that differ from
+ * what is already on the display. The text is padded with spaces to fill
+ * the field and clipped at the end of the row. Control characters are not
+ * interpreted. Nothing is sent if the field already shows the text.
+ *
+ * column - byte 0 to 19
+ * row - byte 0 to 3
+ * text - characters to show
+ * width - field width in cells, 0 to use the length of text
+ *
+ * When run by service(budget) from a task that doesn't fit its time slice,
+ * only the cells that fit are sent and truncated() is set; calling update()
+ * again with the same text sends the rest. At least one cell is always sent.
+ *
+ * returns: boolean true if the field is up to date, or truncated() and the
+ * cells sent so far made it.
+ */
+bool SerLCD::update(byte col, byte row, const char *text, byte width) {
+  if (text == NULL) { text = ""; }
+
+  return update(col, row, text, min(strlen(text), (size_t)MAX_COLUMNS), width);
+} // update
+
+/*
+ * Same as update() above, for text of a given length rather than a string,
+ * so that cells holding custom character 0 are sent as data instead of
+ * ending the text, e.g. a row copied with charAt().
+ *
+ * text - length characters to show
+ * length - characters in text
+ * width - field width in cells, 0 to use length
+ */
+bool SerLCD::update(byte col, byte row, const char *text, byte length, byte width) {
+  _truncated = false;
+  if (col >= MAX_COLUMNS || row >= MAX_ROWS) { return false; }
+  if (text == NULL) { length = 0; }
+
+  if (width == 0) { width = min(length, MAX_COLUMNS); }
+  width = min(width, MAX_COLUMNS - col);
+
+  bool sending = false;
+  for (byte i = 0; i < width; i++) {
+    byte c = (i < length) ? text[i] : ' ';
+    if (_frame[row][col + i] == c) { continue; }
+
+    //Re-sending up to two unchanged cells is cheaper than a 2-byte address command
+    byte gap = col + i - _col;
+    bool jump = (_cursorPending || _row != row || _col > col + i || gap > 2);
+
+    //Leave the rest for the next call once the time slice is used up
+    if (sending && _sliceTime > 0 && busTime(_txBytes + (jump ? 3 : gap + 1)) > _sliceTime) {
+      _truncated = true;
+      break;
+    }
+
+    if (!sending) {
+      if (!beginTransmission()) { return false; } // transmit to device
+      sending = true;
+    }
+
+    if (jump) {
+      _col = col + i;
+      _row = row;
+      _cursorPending = true;
+      _wrapPending = false;
+    }
+    else {
+      while (_col < col + i) {
+        if (!putText(_frame[row][_col])) { return false; }
+      } // while
+    }
+
+    if (!putText(c)) { return false; }
+  } // for
+
+  if (sending) {
+    if (!endTransmission()) { return false; } //Stop transmission
+    settle(10);
+  }
+  return true;
+} // update
+
+/*
+ * Send the tracked cursor position as part of an ongoing transmission if it
+ * is still pending. Used ahead of text and of commands that act at the
+ * display's own cursor, so they need no transmission and pause of their own.
+ */
+bool SerLCD::transmitCursor() {
+  if (!_cursorPending) { return true; }
+
+  if (transmit(SPECIAL_COMMAND) &&                           //Send special command character
+      transmit(LCD_SETDDRAMADDR | ddramAddress(_col, _row)))  //Move to the tracked cursor
+  {
+    _cursorPending = false;
+    _wrapPending = false; //The display is back on the last column
+    return true;
+  }
+  else { return false; }
+} // transmitCursor
+
+/*
+ * Send a special command that acts at the display's cursor, preceded in the
+ * same transmission by the tracked cursor address if it is pending.
+ *
+ * byte command to send
+ * byte count number of times to send
+ */
+bool SerLCD::cursorCommand(byte command, byte count) {
+  if (beginTransmission() && transmitCursor()) // transmit to device
+  {
+    for (int i = 0; i < count; i++) {
+      if (!transmit(SPECIAL_COMMAND) || //Send special command character
+          !transmit(command))           //Send command code
+      {
+        return false;
+      }
+    } // for
+
+    if (endTransmission()) //Stop transmission
+    {
+      settle(50); //Wait a bit longer for special display commands
+      return true;
+    }
+    else { return false; }
+  }
+  else { return false; }
+} // cursorCommand
+
+/*
+ * Forget the tracked contents after the display has been cleared.
+ */
+void SerLCD::resetFrame() {
+  memset(_frame, ' ', sizeof(_frame));
+  _col = 0;
+  _row = 0;
+  _cursorPending = false;
+  _wrapPending = false;
+} // resetFrame
+
+/*
+ * Move the tracked cursor by one cell the way the display's address counter does,
+ * which runs from the end of row 0 into row 2, then row 1, then row 3.
+ *
+ * forward - true to move right, false to move left
+ */
+void SerLCD::stepCursor(bool forward) {
+  if (forward) {
+    if (_col >= MAX_COLUMNS) { return; } //Past the visible row, see setCursor()
+    if (++_col < MAX_COLUMNS) { return; }
+    _col = 0;
+    _row = nextRow[_row];
+  }
+  else {
+    if (_col > 0) { _col--; return; }
+    _col = MAX_COLUMNS - 1;
+    _row = prevRow[_row];
+  }
+} // stepCursor
+
+/*
+ * Move the tracked cursor past a character that was just written. With line
+ * wrapping on, a character in the last column of a row leaves the cursor
+ * there with a wrap pending, and the next printable character carries it
+ * out (see wrapLine()). A '\r' or '\n' in between drops it, so the line
+ * break after a full row doesn't skip a row.
+ */
+void SerLCD::advanceCursor() {
+  if (_lineWrap && _col == MAX_COLUMNS - 1) {
+    _wrapPending = true;
+    _cursorPending = true; //The display's address counter has moved on by itself
+    return;
+  }
+
+  stepCursor(true);
+} // advanceCursor
+
+/*
+ * Carry out a pending wrap: move the tracked cursor to the start of the row
+ * below. Only the wrap from row 3 to row 0 matches the controller's address
+ * counter and needs no command; otherwise the address is sent with the next
+ * character.
+ */
+void SerLCD::wrapLine() {
+  if (!_wrapPending) { return; }
+
+  byte next = nextRow[_row];
+  _wrapPending = false;
+  _col = 0;
+  _row = (_row + 1) % MAX_ROWS;
+  _cursorPending = (_row != next);
+} // wrapLine
+
+/*
+ * DDRAM address of a cell.
+ */
+byte SerLCD::ddramAddress(byte col, byte row) const {
+  return rowOffsets[row] + col;
+} // ddramAddress
+
+/*
+ * Character last written to a cell, as tracked by the library.
+ * Cells that were never written read as spaces. The tracking assumes
+ * left-to-right text without autoscroll.
+ *
+ * column - byte 0 to 19
+ * row - byte 0 to 3
+ */
+byte SerLCD::charAt(byte col, byte row) const {
+  if (col >= MAX_COLUMNS || row >= MAX_ROWS) { return ' '; }
+
+  return _frame[row][col];
+} // charAt
+
 /*
  * Write a string to the display.
  * Required for Print.
@@ -528,7 +1128,12 @@ size_t SerLCD::write(const uint8_t *buffer, size_t size) {
  *  Move the cursor one character to the left.
  */
  bool SerLCD::moveCursorLeft() {
-  return specialCommand(LCD_CURSORSHIFT | LCD_CURSORMOVE | LCD_MOVELEFT);
+  if (cursorCommand(LCD_CURSORSHIFT | LCD_CURSORMOVE | LCD_MOVELEFT, 1))
+  {
+    stepCursor(false);
+    return true;
+  }
+  else { return false; }
 } // moveCursorLeft
 
 /*
@@ -537,14 +1142,24 @@ size_t SerLCD::write(const uint8_t *buffer, size_t size) {
  *  count byte - number of characters to move
  */
  bool SerLCD::moveCursorLeft(byte count) {
-  return specialCommand(LCD_CURSORSHIFT | LCD_CURSORMOVE | LCD_MOVELEFT, count);
+  if (cursorCommand(LCD_CURSORSHIFT | LCD_CURSORMOVE | LCD_MOVELEFT, count))
+  {
+    while (count--) { stepCursor(false); }
+    return true;
+  }
+  else { return false; }
 } // moveCursorLeft
 
 /*
  *  Move the cursor one character to the right.
  */
  bool SerLCD::moveCursorRight() {
-   return specialCommand(LCD_CURSORSHIFT | LCD_CURSORMOVE | LCD_MOVERIGHT);
+  if (cursorCommand(LCD_CURSORSHIFT | LCD_CURSORMOVE | LCD_MOVERIGHT, 1))
+  {
+    stepCursor(true);
+    return true;
+  }
+  else { return false; }
 } // moveCursorRight
 
 /*
@@ -553,7 +1168,12 @@ size_t SerLCD::write(const uint8_t *buffer, size_t size) {
  *  count byte - number of characters to move
  */
  bool SerLCD::moveCursorRight(byte count) {
-   return specialCommand(LCD_CURSORSHIFT | LCD_CURSORMOVE | LCD_MOVERIGHT, count);
+  if (cursorCommand(LCD_CURSORSHIFT | LCD_CURSORMOVE | LCD_MOVERIGHT, count))
+  {
+    while (count--) { stepCursor(true); }
+    return true;
+  }
+  else { return false; }
 } // moveCursorRight
 
 /*
@@ -607,7 +1227,7 @@ size_t SerLCD::write(const uint8_t *buffer, size_t size) {
           transmit(LCD_DISPLAYCONTROL | _displayControl) && //Turn display on as before
           endTransmission())            //Stop transmission
       {
-        delay(50); //This one is a bit slow
+        settle(50); //This one is a bit slow
         return true;
       }
       else { return false; }
@@ -639,7 +1259,7 @@ bool SerLCD::setFastBacklight(byte r, byte g, byte b) {
       transmit(b) && //Send the blue value
       endTransmission()) //Stop transmission
   {
-    delay(10);
+    settle(10);
     return true;
   }
   else { return false; }
@@ -679,6 +1299,23 @@ bool SerLCD::noAutoscroll() {
   return specialCommand(LCD_ENTRYMODESET | _displayMode);
 } //noAutoscroll
 
+/*
+ * Continue text that runs past the end of a row on the row below.
+ * This is the default.
+ */
+void SerLCD::lineWrap() {
+  _lineWrap = true;
+} // lineWrap
+
+/*
+ * Let text that runs past the end of a row follow the controller's
+ * address order instead, which goes from row 0 to row 2 and from
+ * row 2 to row 1.
+ */
+void SerLCD::noLineWrap() {
+  _lineWrap = false;
+} // noLineWrap
+
 /*
  * Change the contrast from 0 to 255. 120 is default.
  *
@@ -692,7 +1329,7 @@ bool SerLCD::setContrast(byte new_val) {
       transmit(new_val) &&          //Send new contrast value
       endTransmission())            //Stop transmission
   {
-    delay(10); //Wait a little bit
+    settle(10); //Wait a little bit
     return true;
   }
   else { return false; }
@@ -716,9 +1353,337 @@ bool SerLCD::setAddress(byte new_addr) {
   {
     //Update our own address so we can still talk to the display
     _i2cAddr = new_addr;
+    if (_transport) { _transport->setAddress(new_addr); }
 
-    delay(50); //This may take awhile
+    settle(50); //This may take awhile
     return true;
   }
   else { return false; }
-} //setContrast
\ No newline at end of file
+} //setContrast
+
+/*
+ * Choose how the pause the display needs after each command is spent.
+ * By default every command waits in delay() before returning. With defer
+ * set, commands return right away and the pause is only recorded; ready()
+ * reports when it is over, and service() holds back tasks until then.
+ * A command sent too early waits out the rest of the pause first. On SPI,
+ * service() also selects the display ahead of time, so the wait after chip
+ * select becomes a pause too (see selectAhead()).
+ *
+ * defer - true to return without waiting
+ */
+void SerLCD::deferSettling(bool defer) {
+  _deferSettle = defer;
+} // deferSettling
+
+/*
+ * With deferred settling on SPI, pull chip select low as soon as a task is
+ * due and record the time the display needs to enable as a pause, so that
+ * the transmission itself doesn't wait for it in delay(). Other devices on
+ * the same SPI bus must not be used while the display is selected.
+ *
+ * now - current time in millis
+ *
+ * returns: true if the display was selected and tasks have to wait for it.
+ */
+bool SerLCD::selectAhead(unsigned long now) {
+#ifdef ARDUINO
+  if (!_spiPort || _spiSelected) { return false; }
+
+  for (SerLCDTask *t = _tasks; t != NULL; t = t->_nextTask) {
+    if (t->_scheduled && (long)(now - t->_due) >= 0) {
+      digitalWrite(_csPin, LOW);
+      _spiSelected = true;
+      settle(SPI_ENABLE_TIME);
+      return true;
+    }
+  } // for
+#else
+  (void)now; //No SPI port without the Arduino core
+#endif
+
+  return false;
+} // selectAhead
+
+/*
+ * Whether the display has finished with the last command and can take another.
+ * Always true unless settling is deferred.
+ */
+bool SerLCD::ready() const {
+  return settled() && tokens() >= 0;
+} // ready
+
+/*
+ * Whether the pause after the last command is over, regardless of the bus share.
+ */
+bool SerLCD::settled() const {
+  //Elapsed time rather than a deadline, so an old pause never looks pending after rollover
+  return millis() - _settleStart >= _settleTime;
+} // settled
+
+/*
+ * When the display will be ready for the next command, in millis.
+ */
+unsigned long SerLCD::readyAt() const {
+  unsigned long at = _settleStart + _settleTime;
+  long debt = -tokens();
+
+  if (debt > 0) {
+    unsigned long repaid = millis() + (debt + 10L * _busShare - 1) / (10L * _busShare);
+    if ((long)(repaid - at) > 0) { at = repaid; }
+  }
+  return at;
+} // readyAt
+
+/*
+ * Limit the display to a share of the bus time, with a token bucket: every
+ * transmission is charged its estimated bus time (see busTime()), time is
+ * earned back at percent of real time, and while the balance is negative
+ * the display is not ready(). Blocking calls wait for the balance to
+ * recover; service() defers its tasks, so queued values and fields simply
+ * show their latest state once the budget allows. 100 removes the limit.
+ *
+ * percent - share of bus time, 1 to 100
+ * burst   - bus time in microseconds that can be saved up while idle
+ */
+void SerLCD::setBusShare(byte percent, unsigned long burst) {
+  _busShare = max(1, min(percent, 100));
+  _burst = burst;
+  _tokens = burst;
+  _tokenTime = millis();
+} // setBusShare
+
+/*
+ * Bus time available now: the balance at the last charge plus what has
+ * been earned since, up to the burst size.
+ */
+long SerLCD::tokens() const {
+  if (_busShare >= 100) { return 0; }
+
+  //Every ms of real time earns 10 * percent us of bus time
+  unsigned long elapsed = millis() - _tokenTime;
+  unsigned long full = (_burst - _tokens) / (10UL * _busShare) + 1;
+  if (elapsed >= full) { return _burst; }
+
+  return _tokens + (long)(elapsed * 10UL * _busShare);
+} // tokens
+
+/*
+ * Pause after a command. Consecutive pauses add up, in either mode. A new
+ * pause starts now unless the last one is still running; being in debt
+ * for bus time doesn't count, or the pause would be added to one long over.
+ *
+ * ms - time the display needs in ms
+ */
+void SerLCD::settle(unsigned long ms) {
+  if (_deferSettle) {
+    if (settled()) {
+      _settleStart = millis();
+      _settleTime = ms;
+    }
+    else { _settleTime += ms; }
+  }
+  else { delay(ms); }
+} // settle
+
+/*
+ * Wait out whatever is left of a deferred pause.
+ */
+void SerLCD::waitReady() {
+  unsigned long elapsed = millis() - _settleStart;
+  if (elapsed < _settleTime) { delay(_settleTime - elapsed); }
+
+  //Then for the bus share to be earned back
+  long debt = -tokens();
+  if (debt > 0) { delay((debt + 10L * _busShare - 1) / (10L * _busShare)); }
+} // waitReady
+
+/*
+ * Attach a task so that it is driven by service().
+ * Attaching a task that is already attached has no effect.
+ *
+ * task - the task to attach
+ */
+void SerLCD::attach(SerLCDTask &task) {
+  for (SerLCDTask *t = _tasks; t != NULL; t = t->_nextTask) {
+    if (t == &task) { return; }
+  } // for
+
+  task._nextTask = _tasks;
+  _tasks = &task;
+} // attach
+
+/*
+ * Detach a task so that it is no longer driven by service().
+ *
+ * task - the task to detach
+ */
+void SerLCD::detach(SerLCDTask &task) {
+  for (SerLCDTask **t = &_tasks; *t != NULL; t = &(*t)->_nextTask) {
+    if (*t == &task) {
+      *t = task._nextTask;
+      task._nextTask = NULL;
+      return;
+    }
+  } // for
+} // detach
+
+/*
+ * Run every attached task whose due time has passed. Call this from loop();
+ * it returns immediately when nothing is due.
+ *
+ * returns: false if any task failed to communicate with the display.
+ */
+bool SerLCD::service() {
+  unsigned long now = millis();
+  bool ok = true;
+
+  if (!ready()) { return true; } //Still busy with the last command
+  if (_deferSettle && selectAhead(now)) { return true; }
+
+  for (SerLCDTask *t = _tasks; t != NULL && ready(); t = t->_nextTask) {
+    //Signed difference keeps the comparison valid across millis() rollover
+    if (t->_scheduled && (long)(now - t->_due) >= 0) {
+      t->_scheduled = false;
+      if (!t->run(*this, now)) { ok = false; }
+    }
+  } // for
+
+  return ok;
+} // service
+
+/*
+ * Like service(), but only runs tasks whose projected transfer time fits in
+ * what is left of a time budget, and never waits for the display to settle
+ * (see deferSettling()). Tasks that don't fit stay due and get their turn on
+ * a later call, so a main loop with a fixed slot for the display never
+ * overruns it. A task too big for the whole budget, e.g. a full row needs
+ * about 2.1 ms at 100 kHz, is run alone in an empty slot with its field
+ * updates cut at the budget (see update()); the queue and the mailbox send
+ * the rest on the following calls. Other commands are always sent whole.
+ *
+ * budget - time slice in microseconds
+ *
+ * returns: false if any task failed to communicate with the display.
+ */
+bool SerLCD::service(uint16_t budget) {
+  unsigned long now = millis();
+  unsigned long used = 0;
+  bool defer = _deferSettle;
+  bool ok = true;
+
+  _deferSettle = true;
+  if (ready() && selectAhead(now)) {
+    _deferSettle = defer;
+    return true;
+  }
+
+  for (SerLCDTask *t = _tasks; t != NULL && ready(); t = t->_nextTask) {
+    if (!t->_scheduled || (long)(now - t->_due) < 0) { continue; }
+
+    unsigned long time = busTime(t->cost());
+    if (used + time <= budget) { used += time; }
+    else if (used == 0) { _sliceTime = budget; } //Too big for any slot, send it in parts
+    else { continue; }                          //A cheaper task further down may still fit
+
+    t->_scheduled = false;
+    if (!t->run(*this, now)) { ok = false; }
+
+    if (_sliceTime > 0) {
+      _sliceTime = 0;
+      break; //The slot is used up
+    }
+  } // for
+  _deferSettle = defer;
+
+  return ok;
+} // service
+
+/*
+ * Set the bit rate of the connection: the I2C clock, the baud rate of
+ * the serial port or the SPI clock. Only used to estimate transfer times.
+ * Default 100000.
+ *
+ * hz - bits per second
+ */
+void SerLCD::setBusClock(unsigned long hz) {
+  if (hz > 0) { _busClock = hz; }
+} // setBusClock
+
+/*
+ * Estimate how long one transmission of a number of bytes keeps the bus busy.
+ * I2C sends 9 bits per byte plus the address byte, a serial port 10 bits
+ * per byte with start and stop bits, and SPI 8 bits per byte; other
+ * transports report their own framing. A shared bus repeats the address
+ * for every chunk.
+ *
+ * bytes - bytes in the transmission
+ *
+ * returns: the time in microseconds.
+ */
+unsigned long SerLCD::busTime(unsigned int bytes) const {
+  unsigned long bitsPerByte = 9;
+  unsigned long header = 1; //Address bytes per transmission or chunk
+
+  if (_transport) {
+    bitsPerByte = _transport->bitsPerByte();
+    header = _transport->headerBytes();
+  }
+#ifdef ARDUINO
+  else if (_serialPort) {
+    bitsPerByte = 10;
+    header = 0;
+  } else if (_spiPort) {
+    bitsPerByte = 8;
+    header = 0;
+  }
+#endif
+
+  unsigned long headers = (_arbiter) ? header * ((bytes + _chunkSize - 1) / _chunkSize) : header;
+  unsigned long bits = bitsPerByte * (bytes + headers);
+
+  return (bits * 1000000UL + _busClock - 1) / _busClock;
+} // busTime
+
+/*
+ * Find when service() next has work to do, so that a caller with its own
+ * event loop can sleep until then instead of polling.
+ *
+ * due - set to the earliest due time of the scheduled tasks, in millis
+ *
+ * returns: false if no task is scheduled.
+ */
+bool SerLCD::nextDeadline(unsigned long &due) const {
+  bool found = false;
+
+  for (SerLCDTask *t = _tasks; t != NULL; t = t->_nextTask) {
+    if (t->_scheduled && (!found || (long)(t->_due - due) < 0)) {
+      due = t->_due;
+      found = true;
+    }
+  } // for
+
+  //Nothing can be sent before the display is ready
+  if (found && !ready() && (long)(readyAt() - due) > 0) { due = readyAt(); }
+
+  return found;
+} // nextDeadline
+
+//<<constructor>>
+SerLCDTask::SerLCDTask(){
+}
+
+/*
+ * Mark the task to be run by service() once millis() reaches due.
+ */
+void SerLCDTask::schedule(unsigned long due) {
+  _due = due;
+  _scheduled = true;
+} // schedule
+
+/*
+ * Stop the task from being run until it is scheduled again.
+ */
+void SerLCDTask::unschedule() {
+  _scheduled = false;
+} // unschedule
@@ -1,14 +1,44 @@
 #ifndef QWIIC_SER_LCD_H
 #define QWIIC_SER_LCD_H
 
+#ifdef ARDUINO
 #include <Arduino.h>
 #include <I2C.h>
 #include <Stream.h>
 #include <SPI.h>
+#else
+#include "serLCD_linux_shim.h" //Just enough of the core to run over a SerLCDTransport
+#endif
+#include <stdarg.h>
+#include <stdio.h>
+#include "serLCD_transport.h"
+#ifdef ARDUINO
+#include "serLCD_mux.h"
+#endif
+
+/*
+ * Decides when the display may use a bus it shares with other devices,
+ * see SerLCD::setArbiter(). acquire() is called before each chunk of a
+ * transmission and may first let other devices use the bus; release() is
+ * called after each chunk. Before the first chunk acquire() may return
+ * false to abandon the transmission. Later chunks can't be abandoned,
+ * since the display would be left halfway through a command, so acquire()
+ * is called again until it grants the bus.
+ */
+class SerLCDBusArbiter {
+
+public:
+  virtual ~SerLCDBusArbiter() {}
+  virtual bool acquire() = 0;
+  virtual void release() = 0;
+};
 
 #define DISPLAY_ADDRESS1 0x72 //This is the default address of the OpenLCD
 #define MAX_ROWS      	  4
 #define MAX_COLUMNS  	 20
+#define TAB_WIDTH     	  4 //Columns between tab stops for '\t'
+#define TASK_DEFAULT_COST 16 //Bytes assumed for a task that doesn't estimate its own
+#define SPI_ENABLE_TIME   10 //ms the display needs after chip select before it takes SPI data
 
 //OpenLCD command characters
 #define SPECIAL_COMMAND  254  //Magic number for sending a special command
@@ -48,13 +78,42 @@
 #define LCD_MOVERIGHT   0x04
 #define LCD_MOVELEFT    0x00
 
+class SerLCD;
+
+/*
+ * A unit of deferred display work driven by SerLCD::service().
+ * Derived classes implement run(), which is called from the main loop once the
+ * task's due time (in millis) has passed. A task is only run again after it
+ * reschedules itself. cost() is an upper bound on the bytes the next run()
+ * sends, which service(budget) uses to stay within its time slice.
+ */
+class SerLCDTask {
+
+public:
+  SerLCDTask();
+  virtual ~SerLCDTask() {}
+  virtual bool run(SerLCD &lcd, unsigned long now) = 0;
+  virtual byte cost() const { return TASK_DEFAULT_COST; }
+  void schedule(unsigned long due);
+  void unschedule();
+  bool scheduled() const { return _scheduled; }
+  unsigned long due() const { return _due; }
+private:
+  friend class SerLCD;
+  SerLCDTask *_nextTask = NULL; //Next task attached to the same display
+  unsigned long _due = 0;
+  bool _scheduled = false;
+};
+
 class SerLCD : public Print {
 
 public:
 	SerLCD();
 	~SerLCD();
+#ifdef ARDUINO
 	bool begin(I2C &wirePort);
 	void begin(I2C &wirePort, byte i2c_addr);
+	bool begin(I2C &wirePort, byte i2c_addr, SerLCDMux &mux, byte channel);
 	void begin(Stream &serial);
 	void begin(SPIClass &spiPort, byte csPin);
 //Only available for Arduino 1.6 and greater
@@ -62,14 +121,22 @@ public:
     //pass SPISettings by value to allow settings object creation in fucntion call like examples
     void begin(SPIClass &spiPort, byte csPin, SPISettings spiSettings);
 #endif
+#endif // ARDUINO
+	bool begin(SerLCDTransport &transport);
 	bool clear();
 	bool home();
 	bool setCursor(byte col, byte row);
-	bool createChar(byte location, byte charmap[]);
+	bool createChar(byte location, const byte charmap[]);
   bool writeChar(byte location);
+  bool overwrite(byte col, byte row, byte c);
 	virtual size_t write(uint8_t);
 	virtual size_t write(const uint8_t *buffer, size_t size);
     virtual size_t write(const char *str);
+  bool update(byte col, byte row, const char *text, byte width = 0);
+  bool update(byte col, byte row, const char *text, byte length, byte width);
+  bool truncated() const { return _truncated; }
+  size_t printf(const char *format, ...);
+  size_t printf_P(PGM_P format, ...);
 	bool noDisplay();
   bool display();
   bool noCursor();
@@ -92,29 +159,102 @@ public:
   bool rightToLeft();
   bool autoscroll();
   bool noAutoscroll();
+  void lineWrap();
+  void noLineWrap();
   bool setContrast(byte new_val);
   bool setAddress(byte new_addr);
 	bool command(byte command);
 	bool specialCommand(byte command);
     bool specialCommand(byte command, byte count);
+  byte cursorColumn() const { return _col; }
+  byte cursorRow() const { return _row; }
+  byte charAt(byte col, byte row) const;
+  void attach(SerLCDTask &task);
+  void detach(SerLCDTask &task);
+  bool service();
+  bool service(uint16_t budget);
+  void setBusClock(unsigned long hz);
+  void setArbiter(SerLCDBusArbiter *arbiter, byte chunkSize = 16);
+  void setBusShare(byte percent, unsigned long burst = 20000);
+  unsigned long busTime(unsigned int bytes) const;
+  void deferSettling(bool defer);
+  bool ready() const;
+  unsigned long readyAt() const;
+  bool nextDeadline(unsigned long &due) const;
+  SerLCDTransport *transport() const { return _transport; }
 private:
+#ifdef ARDUINO
     I2C *_i2cPort = NULL; //The generic connection to user's chosen I2C hardware
     Stream   *_serialPort = NULL; //The generic connection to user's chosen serial hardware
     SPIClass *_spiPort = NULL;  //The generic connection to user's chosen spi hardware
+#endif
+    SerLCDTransport *_transport = NULL; //Any other connection, e.g. a Linux device node
 
 //SPI transactions only available for Arduino 1.6 and later
 #ifdef SPI_HAS_TRANSACTION
     SPISettings _spiSettings = SPISettings(100000, MSBFIRST, SPI_MODE0);
     bool        _spiTransaction = false;  //since we pass by value, we need a flag
 #endif
+#ifdef ARDUINO
     byte  _csPin = 10;
+    bool  _spiSelected = false; //Chip select pulled low ahead of the next transmission, see selectAhead()
+    SerLCDMux *_mux = NULL; //Multiplexer the display sits behind, NULL if none
+    byte _muxChannel = 0;
+#endif
 	byte _i2cAddr = DISPLAY_ADDRESS1;
 	byte _displayControl = LCD_DISPLAYON | LCD_CURSOROFF | LCD_BLINKOFF;
     byte _displayMode    = LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT;
+    SerLCDTask *_tasks = NULL; //Tasks driven by service()
+    unsigned long _busClock = 100000; //Bit rate of the connection, for estimating transfer times
+    SerLCDBusArbiter *_arbiter = NULL; //Shares the bus with other devices, NULL if not shared
+    byte _chunkSize = 16;              //Bytes sent per bus grant when shared
+    byte _chunkBytes = 0;              //Bytes sent in the current chunk
+    unsigned int _txBytes = 0;         //Bytes sent in the current transmission
+    unsigned long _sliceTime = 0;      //Bus time in us update() may use, 0 for no limit
+    bool _truncated = false;           //The last update() stopped at _sliceTime
+    bool _txOpen = false;              //A transmission is under way and no byte of it has failed
+
+    //Token bucket limiting the share of bus time, in microseconds of bus time
+    byte _busShare = 100;              //Percent of bus time the display may use
+    unsigned long _burst = 20000;      //Most bus time that can be saved up
+    long _tokens = 0;                  //Bus time available at _tokenTime, negative when in debt
+    unsigned long _tokenTime = 0;      //millis() when _tokens was last brought up to date
+
+    //What has been written to the display, used to turn control characters into cursor moves
+    byte _frame[MAX_ROWS][MAX_COLUMNS]; //Character in each cell of the display
+    byte _col = 0;                      //Column the next character goes to
+    byte _row = 0;                      //Row the next character goes to
+    bool _cursorPending = false;        //true if the display's address counter is not at _col, _row yet
+    bool _wrapPending = false;          //The last column of a row was written, wrap with the next character
+    bool _deferSettle = false;          //Record pauses after commands instead of waiting them out
+    unsigned long _settleStart = 0;     //millis() when the current pause began
+    unsigned long _settleTime = 0;      //Length of the current pause in ms
+    bool _lineWrap = true;              //Continue text on the next row down instead of the controller's next row
     bool init();
     bool beginTransmission();
     bool transmit(byte data);
     bool endTransmission();
+    bool openPort();
+    bool selectAhead(unsigned long now);
+    bool closePort();
+    bool put(byte c);
+    static bool movesCursorOnly(byte c);
+    void settle(unsigned long ms);
+    void waitReady();
+    bool settled() const;
+    long tokens() const;
+    size_t vformat(const char *format, va_list args, bool progmem);
+#ifdef __AVR__
+    static int formatPut(char c, FILE *stream);
+#endif
+    bool putText(byte c);
+    bool transmitCursor();
+    bool cursorCommand(byte command, byte count);
+    void resetFrame();
+    void stepCursor(bool forward);
+    void advanceCursor();
+    void wrapLine();
+    byte ddramAddress(byte col, byte row) const;
 };
 
 #endif
\ No newline at end of file
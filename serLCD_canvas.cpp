@@ -0,0 +1,148 @@
+/*
+ * Pixel canvas for the SerLCD, mapped onto the eight custom characters.
+ *
+ * Usage:
+ *   SerLCDCanvas plot(4, 2);  //20x16 pixels using CGRAM slots 0 to 7
+ *   plot.place(lcd, 16, 2);   //Put the glyphs on screen once
+ *   ...
+ *   plot.clear();
+ *   plot.drawLine(0, 15, 19, 0);
+ *   plot.flush(lcd);          //Upload only the glyphs that changed
+ *
+ * Each glyph upload takes about 50 ms, so keeping drawing changes local to a few
+ * cells keeps updates quick.
+ */
+#include "serLCD_canvas.h"
+
+/*
+ * byte cellsWide     - canvas width in character cells
+ * byte cellsHigh     - canvas height in character cells
+ * byte firstLocation - first CGRAM slot to use; the canvas takes cellsWide * cellsHigh slots
+ */
+SerLCDCanvas::SerLCDCanvas(byte cellsWide, byte cellsHigh, byte firstLocation) {
+  //keep the canvas within the 8 available slots
+  _firstLocation = min(firstLocation, CANVAS_MAX_CELLS - 1);
+  _cellsWide = max(1, min(cellsWide, CANVAS_MAX_CELLS - _firstLocation));
+  _cellsHigh = max(1, min(cellsHigh, (CANVAS_MAX_CELLS - _firstLocation) / _cellsWide));
+
+  clear();
+}
+
+/*
+ * Turn every pixel off.
+ */
+void SerLCDCanvas::clear() {
+  memset(_glyphs, 0, sizeof(_glyphs));
+} // clear
+
+/*
+ * Set a single pixel. Pixels outside the canvas are ignored.
+ *
+ * x, y - pixel position, (0, 0) being the top left
+ * on   - true to turn the pixel on
+ */
+void SerLCDCanvas::setPixel(byte x, byte y, bool on) {
+  if (x >= width() || y >= height()) { return; }
+
+  byte *line = &_glyphs[(y / CELL_HEIGHT) * _cellsWide + x / CELL_WIDTH][y % CELL_HEIGHT];
+  byte mask = 0x10 >> (x % CELL_WIDTH); //bit 4 is the leftmost pixel of a cell
+
+  if (on) { *line |= mask; }
+  else    { *line &= ~mask; }
+} // setPixel
+
+/*
+ * Read back a single pixel. Pixels outside the canvas read as off.
+ */
+bool SerLCDCanvas::getPixel(byte x, byte y) const {
+  if (x >= width() || y >= height()) { return false; }
+
+  return _glyphs[(y / CELL_HEIGHT) * _cellsWide + x / CELL_WIDTH][y % CELL_HEIGHT] & (0x10 >> (x % CELL_WIDTH));
+} // getPixel
+
+/*
+ * Draw a straight line between two pixels, inclusive (Bresenham).
+ */
+void SerLCDCanvas::drawLine(byte x0, byte y0, byte x1, byte y1, bool on) {
+  int x = x0;
+  int y = y0;
+  int dx = abs((int)x1 - x);
+  int dy = -abs((int)y1 - y);
+  int sx = (x < x1) ? 1 : -1;
+  int sy = (y < y1) ? 1 : -1;
+  int err = dx + dy;
+
+  while (true) {
+    setPixel(x, y, on);
+    if (x == x1 && y == y1) { break; }
+
+    int e2 = 2 * err;
+    if (e2 >= dy) { err += dy; x += sx; }
+    if (e2 <= dx) { err += dx; y += sy; }
+  } // while
+} // drawLine
+
+/*
+ * Forget what is in CGRAM so the next flush() uploads every glyph,
+ * e.g. after another part of the program reused the slots.
+ */
+void SerLCDCanvas::invalidate() {
+  _uploadedMask = 0;
+} // invalidate
+
+/*
+ * Write the canvas glyphs onto the screen with its top left cell at col, row.
+ * Only needs to be done once; later drawing shows up through flush().
+ */
+bool SerLCDCanvas::place(SerLCD &lcd, byte col, byte row) {
+  for (byte r = 0; r < _cellsHigh; r++) {
+    if (!lcd.setCursor(col, row + r)) { return false; }
+
+    for (byte c = 0; c < _cellsWide; c++) {
+      if (!lcd.writeChar(_firstLocation + r * _cellsWide + c)) { return false; }
+    } // for
+  } // for
+
+  return true;
+} // place
+
+/*
+ * Upload the glyphs whose bitmaps differ from what is already in CGRAM.
+ *
+ * maxGlyphs - most glyphs to upload in this call; dirty() tells whether
+ *             any are left for the next one
+ */
+bool SerLCDCanvas::flush(SerLCD &lcd, byte maxGlyphs) {
+  byte cells = _cellsWide * _cellsHigh;
+
+  for (byte i = 0; i < cells && maxGlyphs > 0; i++) {
+    if (!changed(i)) { continue; }
+
+    if (!lcd.createChar(_firstLocation + i, _glyphs[i])) { return false; }
+
+    memcpy(_uploaded[i], _glyphs[i], CELL_HEIGHT);
+    _uploadedMask |= (1 << i);
+    maxGlyphs--;
+  } // for
+
+  return true;
+} // flush
+
+/*
+ * Whether any glyph still has to be uploaded by flush().
+ */
+bool SerLCDCanvas::dirty() const {
+  byte cells = _cellsWide * _cellsHigh;
+
+  for (byte i = 0; i < cells; i++) {
+    if (changed(i)) { return true; }
+  } // for
+  return false;
+} // dirty
+
+/*
+ * Whether a glyph's bitmap differs from what is in CGRAM.
+ */
+bool SerLCDCanvas::changed(byte i) const {
+  return !(_uploadedMask & (1 << i)) || memcmp(_glyphs[i], _uploaded[i], CELL_HEIGHT) != 0;
+} // changed
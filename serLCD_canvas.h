@@ -0,0 +1,40 @@
+#ifndef SER_LCD_CANVAS_H
+#define SER_LCD_CANVAS_H
+
+#include "serLCD_cI2C.h"
+
+#define CANVAS_MAX_CELLS 8 //The display only has 8 custom characters
+#define CELL_WIDTH       5 //Pixels per character cell
+#define CELL_HEIGHT      8
+
+/*
+ * A small monochrome pixel canvas built out of the custom characters.
+ * The canvas is arranged as cellsWide x cellsHigh cells (at most 8 in total,
+ * e.g. 4x2 for 20x16 pixels or 8x1 for 40x8 pixels). Drawing only touches RAM;
+ * flush() uploads just the glyphs whose bitmaps changed since the last upload.
+ */
+class SerLCDCanvas {
+
+public:
+  SerLCDCanvas(byte cellsWide, byte cellsHigh, byte firstLocation = 0);
+  byte width() const { return _cellsWide * CELL_WIDTH; }
+  byte height() const { return _cellsHigh * CELL_HEIGHT; }
+  void clear();
+  void setPixel(byte x, byte y, bool on = true);
+  bool getPixel(byte x, byte y) const;
+  void drawLine(byte x0, byte y0, byte x1, byte y1, bool on = true);
+  void invalidate();
+  bool place(SerLCD &lcd, byte col, byte row);
+  bool flush(SerLCD &lcd, byte maxGlyphs = CANVAS_MAX_CELLS);
+  bool dirty() const;
+private:
+  byte _cellsWide;
+  byte _cellsHigh;
+  byte _firstLocation;                          //First CGRAM slot used by the canvas
+  byte _glyphs[CANVAS_MAX_CELLS][CELL_HEIGHT];   //Bitmaps being drawn
+  byte _uploaded[CANVAS_MAX_CELLS][CELL_HEIGHT]; //Bitmaps currently in CGRAM
+  byte _uploadedMask = 0;                       //Bit set for each glyph whose _uploaded copy is valid
+  bool changed(byte i) const;
+};
+
+#endif
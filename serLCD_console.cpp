@@ -0,0 +1,72 @@
+/*
+ * Scrolling log console for the SerLCD.
+ *
+ * Usage:
+ *   SerLCDConsole log(lcd, 1, 3); //Rows 1 to 3, full width
+ *   log.println("Pump started");  //Scrolls the region up by one line
+ *
+ * Lines longer than the region are wrapped onto the next line.
+ */
+#include "serLCD_console.h"
+
+/*
+ * SerLCD lcd      - display the console is shown on
+ * byte  firstRow  - top row of the region
+ * byte  rows      - number of rows in the region
+ * byte  firstCol  - left column of the region
+ * byte  cols      - number of columns in the region
+ */
+SerLCDConsole::SerLCDConsole(SerLCD &lcd, byte firstRow, byte rows, byte firstCol, byte cols) : _lcd(&lcd) {
+  //keep the region on the display
+  _firstRow = min(firstRow, MAX_ROWS - 1);
+  _rows     = max(1, min(rows, MAX_ROWS - _firstRow));
+  _firstCol = min(firstCol, MAX_COLUMNS - 1);
+  _cols     = max(1, min(cols, MAX_COLUMNS - _firstCol));
+}
+
+/*
+ * Collect a character into the current line.
+ * Required for Print.
+ */
+size_t SerLCDConsole::write(uint8_t c) {
+  if (c == '\r') { return 1; }
+  if (c == '\n') { return newLine() ? 1 : 0; }
+
+  if (_length == _cols && !newLine()) { return 0; }
+
+  _line[_length++] = c;
+  return 1;
+} // write
+
+/*
+ * Scroll the region up by one line and show the current line at the bottom.
+ */
+bool SerLCDConsole::newLine() {
+  char text[MAX_COLUMNS];
+
+  //Rows are sent with their length, so cells showing custom character 0 stay intact
+  for (byte r = 0; r + 1 < _rows; r++) {
+    for (byte c = 0; c < _cols; c++) {
+      text[c] = _lcd->charAt(_firstCol + c, _firstRow + r + 1);
+    } // for
+
+    if (!_lcd->update(_firstCol, _firstRow + r, text, _cols, _cols)) { return false; }
+  } // for
+
+  byte length = _length;
+  _length = 0;
+  return _lcd->update(_firstCol, _firstRow + _rows - 1, _line, length, _cols);
+} // newLine
+
+/*
+ * Blank the region and drop the current line.
+ */
+bool SerLCDConsole::clear() {
+  _length = 0;
+
+  for (byte r = 0; r < _rows; r++) {
+    if (!_lcd->update(_firstCol, _firstRow + r, "", _cols)) { return false; }
+  } // for
+
+  return true;
+} // clear
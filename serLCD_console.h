@@ -0,0 +1,29 @@
+#ifndef SER_LCD_CONSOLE_H
+#define SER_LCD_CONSOLE_H
+
+#include "serLCD_cI2C.h"
+
+/*
+ * A scrolling log console in a rectangular region of the display.
+ * Text printed to the console is collected into a line; each completed line
+ * enters at the bottom of the region and pushes the older lines up.
+ * Only cells that differ after the shift are sent to the display.
+ */
+class SerLCDConsole : public Print {
+
+public:
+  SerLCDConsole(SerLCD &lcd, byte firstRow, byte rows, byte firstCol = 0, byte cols = MAX_COLUMNS);
+  virtual size_t write(uint8_t c);
+  bool newLine();
+  bool clear();
+private:
+  SerLCD *_lcd;
+  byte _firstRow;
+  byte _rows;
+  byte _firstCol;
+  byte _cols;
+  char _line[MAX_COLUMNS];     //Line being collected
+  byte _length = 0;
+};
+
+#endif
@@ -0,0 +1,114 @@
+/*
+ * Inline numeric editor for the SerLCD.
+ *
+ * Usage:
+ *   SerLCDEditor editor(lcd, 10, 1, 4); //4 digits at column 10 of row 1
+ *   editor.begin(setpoint);             //Shows the value, cursor blinks on the last digit
+ *   ...
+ *   if (upPressed)    { editor.increment(); }
+ *   if (leftPressed)  { editor.left(); }
+ *   if (enterPressed) { editor.end(); setpoint = editor.value(); }
+ */
+#include "serLCD_editor.h"
+
+/*
+ * SerLCD lcd     - display the editor is shown on
+ * byte  col, row - position of the leftmost digit
+ * byte  digits   - number of digits, at most EDITOR_MAX_DIGITS
+ */
+SerLCDEditor::SerLCDEditor(SerLCD &lcd, byte col, byte row, byte digits)
+  : _lcd(&lcd), _col(col), _row(row) {
+  _digits = max(1, min(digits, min(EDITOR_MAX_DIGITS, MAX_COLUMNS - min(col, MAX_COLUMNS - 1))));
+}
+
+/*
+ * Show the value with leading zeros and start editing its last digit.
+ */
+bool SerLCDEditor::begin(unsigned long value) {
+  for (byte i = _digits; i-- > 0; ) {
+    _text[i] = '0' + value % 10;
+    value /= 10;
+  } // for
+  _text[_digits] = '\0';
+  _active = _digits - 1;
+
+  return _lcd->update(_col, _row, _text, _digits) &&
+         _lcd->setCursor(_col + _active, _row) &&
+         _lcd->cursor() &&
+         _lcd->blink();
+} // begin
+
+/*
+ * Count the active digit up, from 9 back to 0.
+ */
+bool SerLCDEditor::increment() {
+  return changeDigit(_text[_active] == '9' ? '0' : _text[_active] + 1);
+} // increment
+
+/*
+ * Count the active digit down, from 0 back to 9.
+ */
+bool SerLCDEditor::decrement() {
+  return changeDigit(_text[_active] == '0' ? '9' : _text[_active] - 1);
+} // decrement
+
+/*
+ * Make the digit to the left active.
+ */
+bool SerLCDEditor::left() {
+  if (_active == 0) { return true; }
+
+  if (_lcd->moveCursorLeft())
+  {
+    _active--;
+    return true;
+  }
+  else { return false; }
+} // left
+
+/*
+ * Make the digit to the right active.
+ */
+bool SerLCDEditor::right() {
+  if (_active + 1 >= _digits) { return true; }
+
+  if (_lcd->moveCursorRight())
+  {
+    _active++;
+    return true;
+  }
+  else { return false; }
+} // right
+
+/*
+ * Stop editing and hide the cursor.
+ */
+bool SerLCDEditor::end() {
+  return _lcd->noBlink() && _lcd->noCursor();
+} // end
+
+/*
+ * The value as currently edited.
+ */
+unsigned long SerLCDEditor::value() const {
+  unsigned long value = 0;
+
+  for (byte i = 0; i < _digits; i++) {
+    value = value * 10 + (_text[i] - '0');
+  } // for
+
+  return value;
+} // value
+
+/*
+ * Show a new active digit and put the cursor back onto it, since writing
+ * the digit moves the cursor on. Both go out in one transmission.
+ */
+bool SerLCDEditor::changeDigit(char digit) {
+  if (_lcd->overwrite(_col + _active, _row, digit))
+  {
+    _text[_active] = digit;
+    return true;
+  }
+  else { return false; }
+} // changeDigit
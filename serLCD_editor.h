@@ -0,0 +1,34 @@
+#ifndef SER_LCD_EDITOR_H
+#define SER_LCD_EDITOR_H
+
+#include "serLCD_cI2C.h"
+
+#define EDITOR_MAX_DIGITS 9 //Largest number of digits that fits an unsigned long
+
+/*
+ * Digit-by-digit editor for a setpoint. The display's own blinking cursor
+ * marks the active digit, so nothing is rewritten to make it blink, and each
+ * keypress sends only the one digit that changed.
+ */
+class SerLCDEditor {
+
+public:
+  SerLCDEditor(SerLCD &lcd, byte col, byte row, byte digits);
+  bool begin(unsigned long value);
+  bool increment();
+  bool decrement();
+  bool left();
+  bool right();
+  bool end();
+  unsigned long value() const;
+private:
+  SerLCD *_lcd;
+  byte _col;
+  byte _row;
+  byte _digits;
+  byte _active = 0;                        //Index of the digit being edited, 0 is the leftmost
+  char _text[EDITOR_MAX_DIGITS + 1] = "";  //Digits as shown
+  bool changeDigit(char digit);
+};
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * Numeric display field with deadband for the SerLCD.
+ *
+ * Usage:
+ *   SerLCDNumberField temperature(lcd, 14, 0, 6, 1, 0.15); //"  21.4" at column 14 of row 0
+ *   ...
+ *   temperature.set(readTemperature()); //Only sent when it really changed
+ */
+#include "serLCD_field.h"
+#include <math.h>
+
+/*
+ * SerLCD lcd      - display the field is shown on
+ * byte  col, row  - position of the leftmost cell
+ * byte  width     - field width in cells
+ * byte  decimals  - digits after the decimal point
+ * float deadband  - smallest change from the value on screen that is shown
+ */
+SerLCDNumberField::SerLCDNumberField(SerLCD &lcd, byte col, byte row, byte width, byte decimals, float deadband)
+  : _lcd(&lcd), _col(col), _row(row), _deadband(deadband) {
+  _width = max(1, min(width, MAX_COLUMNS));
+  _decimals = min(decimals, _width);
+}
+
+/*
+ * Show a new value, unless it is within the deadband of the value on screen.
+ * If service(budget) cut the update short, SerLCD::truncated() is set and
+ * the value must be set again to show the rest.
+ *
+ * returns: false if the display could not be updated.
+ */
+bool SerLCDNumberField::set(float value) {
+  if (_shown && fabs(value - _value) <= _deadband) { return true; }
+
+  //Sign, 15 digits, point and decimals; anything bigger can't fit a field anyway
+  char text[MAX_COLUMNS + 18] = "";
+  if (fabs(value) < 1e15) {
+#ifdef __AVR__
+    dtostrf(value, _width, _decimals, text);
+#else
+    snprintf(text, sizeof(text), "%*.*f", _width, _decimals, value);
+#endif
+  }
+
+  //Fill the field with '#' rather than show a truncated number
+  if (text[0] == '\0' || strlen(text) > _width) {
+    memset(text, '#', _width);
+    text[_width] = '\0';
+  }
+
+  if (_lcd->update(_col, _row, text, _width))
+  {
+    if (_lcd->truncated()) { return true; } //Only part is shown, set() the value again to finish
+
+    _value = value;
+    _shown = true;
+    return true;
+  }
+  else { return false; }
+} // set
+
+/*
+ * Change the deadband. Takes effect with the next value.
+ */
+void SerLCDNumberField::setDeadband(float deadband) {
+  _deadband = deadband;
+} // setDeadband
+
+/*
+ * Show the current value again, e.g. after the display was cleared.
+ */
+bool SerLCDNumberField::redraw() {
+  _shown = false;
+  return set(_value);
+} // redraw
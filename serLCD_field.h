@@ -0,0 +1,32 @@
+#ifndef SER_LCD_FIELD_H
+#define SER_LCD_FIELD_H
+
+#include "serLCD_cI2C.h"
+
+/*
+ * A right-aligned number shown in a fixed field of the display.
+ * A new value is only sent when it has moved more than the deadband away
+ * from the value on screen, and then only the digits that changed are sent,
+ * so a noisy reading does not keep flipping the last digit.
+ */
+class SerLCDNumberField {
+
+public:
+  SerLCDNumberField(SerLCD &lcd, byte col, byte row, byte width, byte decimals = 0, float deadband = 0);
+  bool set(float value);
+  void setDeadband(float deadband);
+  bool redraw();
+  float value() const { return _value; }
+  byte width() const { return _width; }
+private:
+  SerLCD *_lcd;
+  byte  _col;
+  byte  _row;
+  byte  _width;
+  byte  _decimals;
+  float _deadband;
+  float _value = 0;     //Value currently on screen
+  bool  _shown = false; //false until the first value has been shown
+};
+
+#endif
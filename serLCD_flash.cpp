@@ -0,0 +1,71 @@
+/*
+ * Alert flashing for the SerLCD.
+ *
+ * Usage:
+ *   SerLCDFlash alarm;            //Blink the text twice a second
+ *   alarm.start(lcd);
+ *   ...
+ *   loop() { lcd.service(); }
+ *   ...
+ *   alarm.stop(lcd);              //Leaves the text showing
+ */
+#include "serLCD_flash.h"
+
+/*
+ * byte         mode   - FLASH_DISPLAY or FLASH_BACKLIGHT
+ * unsigned int period - time for a full on/off cycle in ms
+ */
+SerLCDFlash::SerLCDFlash(byte mode, unsigned int period) : _mode(mode), _period(period) {
+}
+
+/*
+ * Set the backlight colours used in FLASH_BACKLIGHT mode, as 0x00RRGGBB.
+ * The on colour is also what stop() leaves the backlight at.
+ */
+void SerLCDFlash::setColors(unsigned long onRgb, unsigned long offRgb) {
+  _onRgb = onRgb;
+  _offRgb = offRgb;
+} // setColors
+
+/*
+ * Attach the flash to a display and start with the off phase on the next service().
+ * Turns on deferred settling, so service() doesn't wait out the pause after each switch.
+ */
+void SerLCDFlash::start(SerLCD &lcd) {
+  _on = true;
+  lcd.deferSettling(true);
+  lcd.attach(*this);
+  schedule(millis());
+} // start
+
+/*
+ * Stop flashing and leave the screen in its on phase.
+ */
+bool SerLCDFlash::stop(SerLCD &lcd) {
+  unschedule();
+
+  if (_on) { return true; }
+  return showPhase(lcd, true);
+} // stop
+
+/*
+ * Switch to the other phase and schedule the next switch.
+ */
+bool SerLCDFlash::run(SerLCD &lcd, unsigned long now) {
+  schedule(now + _period / 2);
+
+  return showPhase(lcd, !_on);
+} // run
+
+/*
+ * Show the on or off phase.
+ */
+bool SerLCDFlash::showPhase(SerLCD &lcd, bool on) {
+  bool ok;
+
+  if (_mode == FLASH_BACKLIGHT) { ok = lcd.setFastBacklight(on ? _onRgb : _offRgb); }
+  else                          { ok = on ? lcd.display() : lcd.noDisplay(); }
+
+  if (ok) { _on = on; }
+  return ok;
+} // showPhase
@@ -0,0 +1,33 @@
+#ifndef SER_LCD_FLASH_H
+#define SER_LCD_FLASH_H
+
+#include "serLCD_cI2C.h"
+
+//What an alert flash toggles
+#define FLASH_DISPLAY   0 //Blank and show the text with the display on/off bit
+#define FLASH_BACKLIGHT 1 //Switch the backlight between two colours
+
+/*
+ * Flashes the whole screen for an alert without rewriting any text.
+ * Each phase costs a 2-byte display control command, or a 5-byte
+ * backlight command in FLASH_BACKLIGHT mode. Driven by SerLCD::service().
+ */
+class SerLCDFlash : public SerLCDTask {
+
+public:
+  SerLCDFlash(byte mode = FLASH_DISPLAY, unsigned int period = 500);
+  void setColors(unsigned long onRgb, unsigned long offRgb);
+  void start(SerLCD &lcd);
+  bool stop(SerLCD &lcd);
+  virtual bool run(SerLCD &lcd, unsigned long now);
+  virtual byte cost() const { return (_mode == FLASH_BACKLIGHT) ? 5 : 2; }
+private:
+  byte _mode;
+  unsigned int _period;           //Time for a full on/off cycle in ms
+  unsigned long _onRgb = 0xFFFFFF;
+  unsigned long _offRgb = 0x000000;
+  bool _on = true;                //Phase currently shown
+  bool showPhase(SerLCD &lcd, bool on);
+};
+
+#endif
@@ -0,0 +1,194 @@
+/*
+ * Several SerLCDs on several buses, driven together.
+ *
+ * Usage:
+ *   SerLCDGroup cabinet;
+ *   cabinet.add(lcd1, 0);  //Displays on the first bus
+ *   cabinet.add(lcd2, 0);
+ *   cabinet.add(lcd3, 1);  //Displays on the second bus
+ *   ...
+ *   loop() { cabinet.service(); }
+ *
+ * or on Linux, after attaching the displays' tasks:
+ *   cabinet.startThreads();
+ *
+ * While the workers run, each display belongs to its bus thread; hand data
+ * to the displays through SerLCDQueue or SerLCDMailbox, which are safe to
+ * post to from any thread.
+ */
+#include "serLCD_group.h"
+
+#ifdef __linux__
+#include <time.h>
+#endif
+
+//<<constructor>>
+SerLCDGroup::SerLCDGroup() {
+  for (byte i = 0; i < GROUP_MAX_BUSES; i++) {
+    _first[i] = 0;
+#ifdef __linux__
+    _workers[i].started = false;
+#endif
+  } // for
+}
+
+//<<destructor>>
+SerLCDGroup::~SerLCDGroup() {
+#ifdef __linux__
+  stopThreads();
+#endif
+}
+
+/*
+ * Add a display to the group. Its settling is deferred from now on, see
+ * SerLCD::deferSettling().
+ *
+ * lcd - display, already begun
+ * bus - bus the display is on, 0 to GROUP_MAX_BUSES - 1. Displays that share
+ *       wires (including all displays behind one mux) must use the same bus.
+ *
+ * returns: false if the group is full or the bus is out of range.
+ */
+bool SerLCDGroup::add(SerLCD &lcd, byte bus) {
+  if (_count >= GROUP_MAX_DISPLAYS || bus >= GROUP_MAX_BUSES) { return false; }
+
+  lcd.deferSettling(true);
+  _displays[_count] = &lcd;
+  _bus[_count] = bus;
+  _count++;
+  return true;
+} // add
+
+/*
+ * Run the due tasks of every display, bus by bus. Call from loop().
+ *
+ * returns: false if any display failed to communicate.
+ */
+bool SerLCDGroup::service() {
+  bool ok = true;
+
+  for (byte bus = 0; bus < GROUP_MAX_BUSES; bus++) {
+    if (!service(bus)) { ok = false; }
+  } // for
+
+  return ok;
+} // service
+
+/*
+ * Run the due tasks of the displays on one bus. A display still settling is
+ * skipped rather than waited for. The display served first moves along on
+ * every call, so a busy display can't starve the ones after it.
+ *
+ * bus - bus to serve
+ *
+ * returns: false if any display failed to communicate.
+ */
+bool SerLCDGroup::service(byte bus) {
+  bool ok = true;
+  byte served = 0;
+
+  if (bus >= GROUP_MAX_BUSES || _count == 0) { return true; }
+
+  byte first = _first[bus];
+
+  for (byte n = 0; n < _count; n++) {
+    byte i = (first + n) % _count;
+    if (_bus[i] != bus) { continue; }
+
+    if (served++ == 0) { _first[bus] = (i + 1) % _count; }
+    if (!_displays[i]->service()) { ok = false; }
+  } // for
+
+  return ok;
+} // service
+
+#ifdef __linux__
+/*
+ * Start one worker thread for every bus that has displays. Each worker
+ * serves its bus and sleeps until the next deadline on it, see
+ * SerLCD::nextDeadline(). Attach the displays' tasks first.
+ *
+ * returns: false if a thread could not be created; the ones already
+ * started keep running until stopThreads().
+ */
+bool SerLCDGroup::startThreads() {
+  if (_running) { return true; }
+
+  _running = true;
+  for (byte bus = 0; bus < GROUP_MAX_BUSES; bus++) {
+    if (!busy(bus)) { continue; }
+
+    _workers[bus].group = this;
+    _workers[bus].bus = bus;
+    if (pthread_create(&_workers[bus].thread, NULL, work, &_workers[bus]) != 0) { return false; }
+    _workers[bus].started = true;
+  } // for
+
+  return true;
+} // startThreads
+
+/*
+ * Stop the worker threads and wait for them to finish their current
+ * transaction. The displays can then be used from the calling thread again.
+ */
+void SerLCDGroup::stopThreads() {
+  __atomic_store_n(&_running, false, __ATOMIC_RELEASE);
+
+  for (byte bus = 0; bus < GROUP_MAX_BUSES; bus++) {
+    if (_workers[bus].started) {
+      pthread_join(_workers[bus].thread, NULL);
+      _workers[bus].started = false;
+    }
+  } // for
+} // stopThreads
+
+/*
+ * Body of a bus worker.
+ */
+void *SerLCDGroup::work(void *arg) {
+  Worker *worker = (Worker *)arg;
+  SerLCDGroup *group = worker->group;
+
+  while (__atomic_load_n(&group->_running, __ATOMIC_ACQUIRE)) {
+    group->service(worker->bus);
+
+    unsigned long wait = group->idleTime(worker->bus);
+    if (wait > 0) {
+      struct timespec ts = { (time_t)(wait / 1000), (long)(wait % 1000) * 1000000L };
+      nanosleep(&ts, NULL);
+    }
+  } // while
+
+  return NULL;
+} // work
+
+/*
+ * Whether any display is on a bus.
+ */
+bool SerLCDGroup::busy(byte bus) const {
+  for (byte i = 0; i < _count; i++) {
+    if (_bus[i] == bus) { return true; }
+  } // for
+  return false;
+} // busy
+
+/*
+ * How long a bus worker can sleep before one of its displays has work, in
+ * ms, at most GROUP_IDLE_SLEEP so it notices newly scheduled tasks.
+ */
+unsigned long SerLCDGroup::idleTime(byte bus) const {
+  unsigned long now = millis();
+  unsigned long wait = GROUP_IDLE_SLEEP;
+
+  for (byte i = 0; i < _count; i++) {
+    unsigned long due;
+    if (_bus[i] != bus || !_displays[i]->nextDeadline(due)) { continue; }
+
+    long left = (long)(due - now);
+    if (left <= 0) { return 0; }
+    if ((unsigned long)left < wait) { wait = left; }
+  } // for
+
+  return wait;
+} // idleTime
+#endif // __linux__
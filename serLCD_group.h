@@ -0,0 +1,64 @@
+#ifndef SER_LCD_GROUP_H
+#define SER_LCD_GROUP_H
+
+#include "serLCD_cI2C.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+#ifndef GROUP_MAX_DISPLAYS
+#define GROUP_MAX_DISPLAYS 12 //Displays one group can drive
+#endif
+#ifndef GROUP_MAX_BUSES
+#define GROUP_MAX_BUSES    4  //Separate buses (I2C ports, Linux i2c adapters) in one group
+#endif
+#define GROUP_IDLE_SLEEP   10 //Longest a bus worker sleeps with nothing scheduled, in ms
+
+/*
+ * Drives the displays of a cabinet spread over several buses. Every display
+ * is tagged with the bus it is on, and settling is deferred for all of them,
+ * so the pause one display needs after a command no longer holds up the
+ * others: service() moves on to the next display instead of waiting.
+ *
+ * On Linux each bus can also get a worker thread of its own with
+ * startThreads(), so transfers on different adapters really happen at the
+ * same time. Displays on one bus always share a thread, so their
+ * transactions never interleave.
+ */
+class SerLCDGroup {
+
+public:
+  SerLCDGroup();
+  ~SerLCDGroup();
+  bool add(SerLCD &lcd, byte bus = 0);
+  byte count() const { return _count; }
+  SerLCD &display(byte index) { return *_displays[index]; }
+  bool service();
+  bool service(byte bus);
+#ifdef __linux__
+  bool startThreads();
+  void stopThreads();
+#endif
+private:
+  SerLCD *_displays[GROUP_MAX_DISPLAYS];
+  byte _bus[GROUP_MAX_DISPLAYS];         //Bus of each display
+  byte _count = 0;
+  byte _first[GROUP_MAX_BUSES];          //Display served first on each bus, rotated for fairness
+#ifdef __linux__
+  struct Worker {
+    SerLCDGroup *group;
+    byte bus;
+    pthread_t thread;
+    bool started;
+  };
+  Worker _workers[GROUP_MAX_BUSES];
+  volatile bool _running = false;        //Cleared to make the workers exit
+
+  static void *work(void *arg);
+  bool busy(byte bus) const;
+  unsigned long idleTime(byte bus) const;
+#endif
+};
+
+#endif
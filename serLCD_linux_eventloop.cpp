@@ -0,0 +1,151 @@
+/*
+ * epoll/timerfd integration of the SerLCD for Linux.
+ *
+ * Usage:
+ *   SerLCDEventLoop lcdLoop(lcd);
+ *   lcdLoop.attach(epollFd);
+ *   for (;;) {
+ *     int n = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+ *     for (int i = 0; i < n; i++) {
+ *       if (lcdLoop.handle(events[i])) { continue; }
+ *       ...other descriptors...
+ *     }
+ *   }
+ *
+ * After writing to the display or starting a task outside of handle(), call
+ * rearm() so the timer and write interest match the new work.
+ */
+#ifdef __linux__
+
+#include "serLCD_linux_eventloop.h"
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+SerLCDEventLoop::SerLCDEventLoop(SerLCD &lcd) : _lcd(&lcd) {
+}
+
+SerLCDEventLoop::~SerLCDEventLoop() {
+  detach();
+}
+
+/*
+ * Register the deadline timer and the transport's descriptor with an epoll
+ * instance, and defer the display's settling (see SerLCD::deferSettling())
+ * so that handle() never waits in delay().
+ *
+ * returns: false if the timer could not be created or registered.
+ */
+bool SerLCDEventLoop::attach(int epollFd) {
+  detach();
+  _lcd->deferSettling(true);
+
+  _timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (_timerFd < 0) { return false; }
+
+  struct epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = _timerFd;
+  if (epoll_ctl(epollFd, EPOLL_CTL_ADD, _timerFd, &event) < 0) {
+    detach();
+    return false;
+  }
+  _epollFd = epollFd;
+
+  SerLCDTransport *transport = _lcd->transport();
+  if (transport != NULL && transport->fd() >= 0) {
+    event.events = 0; //Only watched for writing while output is queued
+    event.data.fd = transport->fd();
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, transport->fd(), &event) == 0) { _transportFd = transport->fd(); }
+  }
+
+  return rearm();
+} // attach
+
+/*
+ * Remove the descriptors from epoll and close the timer.
+ */
+void SerLCDEventLoop::detach() {
+  if (_epollFd >= 0) {
+    if (_transportFd >= 0) { epoll_ctl(_epollFd, EPOLL_CTL_DEL, _transportFd, NULL); }
+    epoll_ctl(_epollFd, EPOLL_CTL_DEL, _timerFd, NULL);
+  }
+  if (_timerFd >= 0) { close(_timerFd); }
+
+  _epollFd = -1;
+  _timerFd = -1;
+  _transportFd = -1;
+  _watchingWrite = false;
+} // detach
+
+/*
+ * Handle an event returned by epoll_wait(): run due tasks and continue
+ * paced output when the timer fires, continue queued output when the
+ * transport is writable.
+ *
+ * returns: true if the event belonged to the display.
+ */
+bool SerLCDEventLoop::handle(const struct epoll_event &event) {
+  if (_timerFd >= 0 && event.data.fd == _timerFd) {
+    //Clear the expiration count; a failed read just means the timer was rearmed meanwhile
+    uint64_t expirations;
+    ssize_t n = read(_timerFd, &expirations, sizeof(expirations));
+    (void)n;
+
+    if (_transportFd >= 0 && _lcd->transport()->writePending()) { _lcd->transport()->writeMore(); }
+    _lcd->service();
+  }
+  else if (_transportFd >= 0 && event.data.fd == _transportFd) {
+    _lcd->transport()->writeMore();
+  }
+  else { return false; }
+
+  rearm();
+  return true;
+} // handle
+
+/*
+ * Arm the timer for the next task deadline, or for when the display is
+ * ready if that is later (or disarm it if there is no work), and ask for
+ * writability only while the transport has output queued. While the
+ * transport holds its output back for pacing, the port stays writable, so
+ * the timer is armed for the end of the hold instead.
+ */
+bool SerLCDEventLoop::rearm() {
+  if (_timerFd < 0) { return false; }
+
+  long wait = -1; //Time until the timer fires in us, -1 for never
+  unsigned long due;
+  if (_lcd->nextDeadline(due)) {
+    //A task can't run before the pause after the last command is over
+    if (!_lcd->ready() && (long)(_lcd->readyAt() - due) > 0) { due = _lcd->readyAt(); }
+
+    wait = max(0L, (long)(due - millis())) * 1000L;
+  }
+
+  unsigned long held = (_transportFd >= 0) ? _lcd->transport()->writeDelay() : 0;
+  if (held > 0 && (wait < 0 || (long)held < wait)) { wait = held; }
+
+  //A zero it_value would disarm the timer, so overdue work fires right away
+  struct itimerspec timer = {};
+  if (wait == 0) { timer.it_value.tv_nsec = 1; }
+  else if (wait > 0) {
+    timer.it_value.tv_sec  = wait / 1000000L;
+    timer.it_value.tv_nsec = (wait % 1000000L) * 1000L;
+  }
+  if (timerfd_settime(_timerFd, 0, &timer, NULL) < 0) { return false; }
+
+  if (_transportFd >= 0) {
+    bool wantWrite = _lcd->transport()->writePending() && held == 0;
+    if (wantWrite != _watchingWrite) {
+      struct epoll_event event = {};
+      event.events = wantWrite ? (uint32_t)EPOLLOUT : 0;
+      event.data.fd = _transportFd;
+      if (epoll_ctl(_epollFd, EPOLL_CTL_MOD, _transportFd, &event) < 0) { return false; }
+      _watchingWrite = wantWrite;
+    }
+  }
+
+  return true;
+} // rearm
+
+#endif // __linux__
@@ -0,0 +1,38 @@
+#ifndef SER_LCD_LINUX_EVENTLOOP_H
+#define SER_LCD_LINUX_EVENTLOOP_H
+
+#ifdef __linux__
+
+#include "serLCD_cI2C.h"
+#include <sys/epoll.h>
+
+/*
+ * Drives a SerLCD from an application's epoll loop. A timerfd is armed for
+ * the display's next task deadline, and the transport's descriptor is
+ * watched for writability while it has output queued, or the timer is armed
+ * for when a paced transport takes more (see writeDelay()), so the display
+ * needs neither a thread of its own nor periodic polling. Settling is deferred
+ * from attach() on, so the pauses after commands are spent in epoll_wait()
+ * rather than in delay().
+ */
+class SerLCDEventLoop {
+
+public:
+  SerLCDEventLoop(SerLCD &lcd);
+  ~SerLCDEventLoop();
+  bool attach(int epollFd);
+  void detach();
+  bool handle(const struct epoll_event &event);
+  bool rearm();
+  int timerFd() const { return _timerFd; }
+private:
+  SerLCD *_lcd;
+  int _epollFd = -1;
+  int _timerFd = -1;
+  int _transportFd = -1;       //Transport descriptor registered with epoll, -1 if none
+  bool _watchingWrite = false; //EPOLLOUT currently requested for the transport
+};
+
+#endif // __linux__
+
+#endif
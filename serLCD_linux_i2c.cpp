@@ -0,0 +1,153 @@
+/*
+ * Linux i2c-dev transport for the SerLCD.
+ *
+ * Usage:
+ *   SerLCDLinuxI2C bus("/dev/i2c-1");
+ *   SerLCD lcd;
+ *   if (bus.open()) { lcd.begin(bus); }
+ */
+#ifdef __linux__
+
+#include "serLCD_linux_i2c.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+/*
+ * char*   device  - i2c-dev node, e.g. "/dev/i2c-1"
+ * uint8_t address - 7-bit address of the display
+ */
+SerLCDLinuxI2C::SerLCDLinuxI2C(const char *device, uint8_t address) : _device(device), _address(address) {
+}
+
+SerLCDLinuxI2C::~SerLCDLinuxI2C() {
+  close();
+}
+
+/*
+ * Open the device node.
+ *
+ * returns: false if the node could not be opened.
+ */
+bool SerLCDLinuxI2C::open() {
+  close();
+  _fd = ::open(_device, O_RDWR | O_CLOEXEC);
+
+  return _fd >= 0;
+} // open
+
+/*
+ * Close the device node.
+ */
+void SerLCDLinuxI2C::close() {
+  if (_fd >= 0) {
+    ::close(_fd);
+    _fd = -1;
+  }
+  _smbus = false;
+  _slaveAddress = -1;
+} // close
+
+/*
+ * Start gathering a transaction.
+ */
+bool SerLCDLinuxI2C::beginTransmission() {
+  _length = 0;
+
+  return _fd >= 0;
+} // beginTransmission
+
+/*
+ * Add a byte to the transaction, sending what has been gathered
+ * so far if the buffer is full.
+ */
+bool SerLCDLinuxI2C::transmit(uint8_t data) {
+  if (_length == sizeof(_buffer) && !flush()) { return false; }
+
+  _buffer[_length++] = data;
+  return true;
+} // transmit
+
+/*
+ * Send the gathered transaction.
+ */
+bool SerLCDLinuxI2C::endTransmission() {
+  return flush();
+} // endTransmission
+
+/*
+ * Write the buffer as one I2C message with a single ioctl, or as SMBus
+ * writes if the adapter turned out not to support plain I2C messages.
+ */
+bool SerLCDLinuxI2C::flush() {
+  if (_length == 0) { return true; }
+  if (_smbus) { return writeSMBus(); }
+
+  struct i2c_msg message;
+  message.addr  = _address;
+  message.flags = 0;
+  message.len   = _length;
+  message.buf   = _buffer;
+
+  struct i2c_rdwr_ioctl_data transfer;
+  transfer.msgs  = &message;
+  transfer.nmsgs = 1;
+
+  if (ioctl(_fd, I2C_RDWR, &transfer) >= 0) {
+    _length = 0;
+    return true;
+  }
+  if (errno != EOPNOTSUPP) {
+    _length = 0;
+    return false;
+  }
+
+  _smbus = true; //Remember, so later transactions go straight to SMBus
+  return writeSMBus();
+} // flush
+
+/*
+ * Write the buffer as SMBus writes: a single byte as a "send byte", longer
+ * runs as I2C block writes whose command byte is the first byte of the run.
+ * Either way the display receives exactly the buffered bytes.
+ */
+bool SerLCDLinuxI2C::writeSMBus() {
+  uint16_t length = _length;
+  _length = 0;
+
+  if (_slaveAddress != _address) {
+    if (ioctl(_fd, I2C_SLAVE, _address) < 0) { return false; }
+    _slaveAddress = _address;
+  }
+
+  for (uint16_t start = 0; start < length; start += LINUX_I2C_SMBUS_BLOCK) {
+    uint16_t count = length - start;
+    if (count > LINUX_I2C_SMBUS_BLOCK) { count = LINUX_I2C_SMBUS_BLOCK; }
+
+    union i2c_smbus_data data;
+    struct i2c_smbus_ioctl_data transfer;
+    transfer.read_write = I2C_SMBUS_WRITE;
+    transfer.command    = _buffer[start];
+
+    if (count == 1) {
+      transfer.size = I2C_SMBUS_BYTE;
+      transfer.data = NULL;
+    }
+    else {
+      data.block[0] = count - 1;
+      memcpy(&data.block[1], &_buffer[start + 1], count - 1);
+      transfer.size = I2C_SMBUS_I2C_BLOCK_DATA;
+      transfer.data = &data;
+    }
+
+    if (ioctl(_fd, I2C_SMBUS, &transfer) < 0) { return false; }
+  } // for
+
+  return true;
+} // writeSMBus
+
+#endif // __linux__
@@ -0,0 +1,46 @@
+#ifndef SER_LCD_LINUX_I2C_H
+#define SER_LCD_LINUX_I2C_H
+
+#ifdef __linux__
+
+#include "serLCD_transport.h"
+
+#define LINUX_I2C_BUFFER_SIZE 256 //Longer transactions are split into several messages
+#define LINUX_I2C_SMBUS_BLOCK 33  //Most bytes in one SMBus write: the command byte and a 32-byte block
+
+/*
+ * Talks to the OpenLCD through a Linux i2c-dev node such as /dev/i2c-1.
+ * Each SerLCD transaction is gathered in memory and written with a single
+ * I2C_RDWR ioctl instead of a system call per byte. Adapters that only
+ * implement SMBus, such as the kernel's i2c-stub module, reject I2C_RDWR;
+ * the transaction is then sent as SMBus writes of up to 33 bytes, which put
+ * the same bytes on the wire. extras/linux has a test against a fake adapter.
+ */
+class SerLCDLinuxI2C : public SerLCDTransport {
+
+public:
+  SerLCDLinuxI2C(const char *device, uint8_t address = 0x72);
+  ~SerLCDLinuxI2C();
+  bool open();
+  void close();
+  virtual int fd() const { return _fd; }
+  virtual bool beginTransmission();
+  virtual bool transmit(uint8_t data);
+  virtual bool endTransmission();
+  virtual void setAddress(uint8_t address) { _address = address; }
+  bool smbus() const { return _smbus; }
+private:
+  const char *_device;
+  uint8_t _address;
+  int _fd = -1;
+  uint8_t _buffer[LINUX_I2C_BUFFER_SIZE]; //Bytes of the current transaction
+  uint16_t _length = 0;
+  bool _smbus = false;     //The adapter only does SMBus
+  int _slaveAddress = -1;  //Address last set with I2C_SLAVE for SMBus, -1 if none
+  bool flush();
+  bool writeSMBus();
+};
+
+#endif // __linux__
+
+#endif
@@ -0,0 +1,216 @@
+/*
+ * Linux termios serial transport for the SerLCD.
+ *
+ * Usage:
+ *   SerLCDLinuxSerial port("/dev/ttyUSB0");
+ *   SerLCD lcd;
+ *   if (port.open()) { lcd.begin(port); }
+ *   ...
+ *   if (port.pending()) { port.flush(); } //e.g. when poll() reports the port writable
+ */
+#ifdef __linux__
+
+#include "serLCD_linux_serial.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+
+/*
+ * char*   device - tty node, e.g. "/dev/ttyUSB0"
+ * speed_t baud   - termios speed the OpenLCD is set to, e.g. B9600
+ */
+SerLCDLinuxSerial::SerLCDLinuxSerial(const char *device, speed_t baud) : _device(device), _baud(baud) {
+}
+
+SerLCDLinuxSerial::~SerLCDLinuxSerial() {
+  close();
+}
+
+/*
+ * Open the port non-blocking in raw 8N1 mode.
+ *
+ * returns: false if the port could not be opened or configured.
+ */
+bool SerLCDLinuxSerial::open() {
+  struct termios tty;
+
+  close();
+  _fd = ::open(_device, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if (_fd < 0) { return false; }
+
+  if (tcgetattr(_fd, &tty) < 0) {
+    close();
+    return false;
+  }
+
+  cfmakeraw(&tty);
+  tty.c_cflag |= CLOCAL | CREAD;
+  tty.c_cflag &= ~(CSTOPB | CRTSCTS);
+  cfsetispeed(&tty, _baud);
+  cfsetospeed(&tty, _baud);
+
+  if (tcsetattr(_fd, TCSANOW, &tty) < 0) {
+    close();
+    return false;
+  }
+
+  return true;
+} // open
+
+/*
+ * Close the port, dropping anything still queued.
+ */
+void SerLCDLinuxSerial::close() {
+  if (_fd >= 0) {
+    ::close(_fd);
+    _fd = -1;
+  }
+  _head = 0;
+  _length = 0;
+  _staged = 0;
+} // close
+
+/*
+ * Keep the kernel's output queue at or below maxQueued bytes, so that
+ * updates wait here, where they can still be replaced, rather than in the
+ * driver. 0 lets flush() write as much as the port takes.
+ */
+void SerLCDLinuxSerial::setPacing(int maxQueued) {
+  _maxQueued = maxQueued;
+} // setPacing
+
+/*
+ * Bytes written to the port that have not gone out on the wire yet.
+ *
+ * returns: -1 if the queue depth could not be read.
+ */
+int SerLCDLinuxSerial::outputQueue() const {
+  int queued;
+
+  if (ioctl(_fd, TIOCOUTQ, &queued) < 0) { return -1; }
+  return queued;
+} // outputQueue
+
+/*
+ * How long flush() holds the queue back because the kernel's output queue
+ * is at the pacing cap: the time the port needs to send what is queued
+ * there, in microseconds. An event loop waits that long rather than for
+ * writability, which the port reports all along.
+ *
+ * returns: 0 if flush() can write now or nothing is waiting.
+ */
+unsigned long SerLCDLinuxSerial::writeDelay() const {
+  if (_maxQueued <= 0 || !writePending()) { return 0; }
+
+  int queued = outputQueue();
+  if (queued < _maxQueued) { return 0; }
+
+  //Ten bits per byte with the start and stop bits
+  return (unsigned long)((uint64_t)queued * 10 * 1000000 / bitRate(_baud)) + 1;
+} // writeDelay
+
+/*
+ * Bits per second of a termios speed.
+ */
+unsigned long SerLCDLinuxSerial::bitRate(speed_t baud) {
+  switch (baud) {
+    case B1200:    return 1200;
+    case B2400:    return 2400;
+    case B4800:    return 4800;
+    case B19200:   return 19200;
+    case B38400:   return 38400;
+    case B57600:   return 57600;
+    case B115200:  return 115200;
+    case B230400:  return 230400;
+    case B460800:  return 460800;
+    case B921600:  return 921600;
+    case B1000000: return 1000000;
+    default:       return 9600;
+  } // switch
+} // bitRate
+
+/*
+ * Write as much of the queue as the port takes without blocking,
+ * in one writev() covering both halves of the ring buffer. A transaction
+ * still under way is held back until it has ended.
+ *
+ * returns: false on a write error other than the port being full.
+ */
+bool SerLCDLinuxSerial::flush() {
+  size_t limit = _length - _staged;
+
+  if (limit == 0) { return true; }
+  if (_fd < 0) { return false; }
+
+  if (_maxQueued > 0) {
+    int queued = outputQueue();
+    if (queued >= _maxQueued) { return true; }
+    if (queued >= 0 && (size_t)(_maxQueued - queued) < limit) { limit = _maxQueued - queued; }
+  }
+
+  struct iovec parts[2];
+  size_t first = sizeof(_buffer) - _head;
+  if (first > limit) { first = limit; }
+  parts[0].iov_base = _buffer + _head;
+  parts[0].iov_len  = first;
+  parts[1].iov_base = _buffer;
+  parts[1].iov_len  = limit - first;
+
+  ssize_t written = writev(_fd, parts, (parts[1].iov_len > 0) ? 2 : 1);
+  if (written < 0) { return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR; }
+
+  _head = (_head + written) % sizeof(_buffer);
+  _length -= written;
+  return true;
+} // flush
+
+/*
+ * Start staging a transaction at the end of the queue.
+ */
+bool SerLCDLinuxSerial::beginTransmission() {
+  _length -= _staged; //Drop a transaction that was never ended
+  _staged = 0;
+  _dropped = false;
+  return _fd >= 0;
+} // beginTransmission
+
+/*
+ * Stage a byte, making room by flushing earlier transactions if the queue
+ * is full. If there is still no room, the bytes staged so far are taken
+ * back off the queue.
+ *
+ * returns: false if the port is too busy to take the transaction.
+ */
+bool SerLCDLinuxSerial::transmit(uint8_t data) {
+  if (_dropped) { return false; }
+
+  if (_length == sizeof(_buffer) && (!flush() || _length == sizeof(_buffer))) {
+    _length -= _staged;
+    _staged = 0;
+    _dropped = true;
+    return false;
+  }
+
+  _buffer[(_head + _length) % sizeof(_buffer)] = data;
+  _length++;
+  _staged++;
+  return true;
+} // transmit
+
+/*
+ * Hand the staged transaction over to be written, and start writing.
+ *
+ * returns: false if the transaction was dropped or the port failed.
+ */
+bool SerLCDLinuxSerial::endTransmission() {
+  _staged = 0;
+  if (_dropped) {
+    _dropped = false;
+    return false;
+  }
+  return flush();
+} // endTransmission
+
+#endif // __linux__
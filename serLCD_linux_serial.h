@@ -0,0 +1,55 @@
+#ifndef SER_LCD_LINUX_SERIAL_H
+#define SER_LCD_LINUX_SERIAL_H
+
+#ifdef __linux__
+
+#include "serLCD_transport.h"
+#include <stddef.h>
+#include <termios.h>
+
+#define LINUX_SERIAL_BUFFER_SIZE 512 //Bytes waiting to be written to the port
+
+/*
+ * Talks to the OpenLCD's serial input through a POSIX tty such as /dev/ttyUSB0.
+ * The port is non-blocking: transactions are queued in a ring buffer and
+ * written with writev() when they end, and whatever the port could not take
+ * stays queued for the next flush(). A transaction that doesn't fit is
+ * dropped whole, so the display never sees half a command. The kernel's output queue can be capped
+ * to pace the display. Works against a pseudo-terminal for testing.
+ */
+class SerLCDLinuxSerial : public SerLCDTransport {
+
+public:
+  SerLCDLinuxSerial(const char *device, speed_t baud = B9600);
+  ~SerLCDLinuxSerial();
+  bool open();
+  void close();
+  virtual int fd() const { return _fd; }
+  void setPacing(int maxQueued);
+  bool flush();
+  size_t pending() const { return _length; }
+  int outputQueue() const;
+  virtual bool beginTransmission();
+  virtual bool transmit(uint8_t data);
+  virtual bool endTransmission();
+  virtual bool writePending() const { return _length > _staged; }
+  virtual bool writeMore() { return flush(); }
+  virtual unsigned long writeDelay() const;
+  virtual uint8_t bitsPerByte() const { return 10; } //Start and stop bits
+  virtual uint8_t headerBytes() const { return 0; }
+private:
+  const char *_device;
+  speed_t _baud;
+  int _fd = -1;
+  int _maxQueued = 0;                        //Cap on the kernel's output queue, 0 for none
+  uint8_t _buffer[LINUX_SERIAL_BUFFER_SIZE]; //Ring buffer of bytes not written yet
+  size_t _head = 0;                          //Index of the oldest byte
+  size_t _length = 0;                        //Number of bytes queued
+  size_t _staged = 0;                        //Bytes at the end of the queue from the transaction under way
+  bool _dropped = false;                     //The transaction under way did not fit and was dropped
+  static unsigned long bitRate(speed_t baud);
+};
+
+#endif // __linux__
+
+#endif
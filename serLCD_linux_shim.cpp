@@ -0,0 +1,120 @@
+/*
+ * Minimal Arduino core for building the SerLCD library on Linux.
+ *
+ * Usage:
+ *   SerLCDLinuxI2C bus("/dev/i2c-1");
+ *   SerLCD lcd;
+ *   if (bus.open() && lcd.begin(bus)) { lcd.print("Hello"); }
+ *
+ * Compile the library's .cpp files together with the application, e.g.
+ *   g++ -I SerLCD_cI2C app.cpp SerLCD_cI2C/serLCD_*.cpp -pthread
+ * or see extras/linux.
+ */
+#include "serLCD_linux_shim.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <errno.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Time on the monotonic clock, which wall clock changes don't move.
+ */
+static unsigned long long monotonicMicros() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+//Time the process started, so millis() starts near 0 like on a board
+static const unsigned long long startMicros = monotonicMicros();
+
+/*
+ * Milliseconds since the program started. Rolls over like the core's.
+ */
+unsigned long millis() {
+  return (unsigned long)((monotonicMicros() - startMicros) / 1000);
+} // millis
+
+/*
+ * Microseconds since the program started.
+ */
+unsigned long micros() {
+  return (unsigned long)(monotonicMicros() - startMicros);
+} // micros
+
+/*
+ * Sleep for a number of milliseconds, resuming after signals.
+ */
+void delay(unsigned long ms) {
+  struct timespec left = { (time_t)(ms / 1000), (long)(ms % 1000) * 1000000L };
+
+  while (nanosleep(&left, &left) < 0 && errno == EINTR) {}
+} // delay
+
+/*
+ * Write a buffer one byte at a time, stopping at the first byte not taken.
+ */
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+
+  while (size--) {
+    if (write(*buffer++) == 0) { break; }
+    n++;
+  } // while
+  return n;
+} // write
+
+size_t Print::print(const char *str)                { return write(str); }
+size_t Print::print(char c)                         { return write((uint8_t)c); }
+size_t Print::print(unsigned char n, int base)      { return print((unsigned long)n, base); }
+size_t Print::print(int n, int base)                { return print((long)n, base); }
+size_t Print::print(unsigned int n, int base)       { return print((unsigned long)n, base); }
+size_t Print::print(unsigned long n, int base)      { return printNumber(n, base); }
+
+/*
+ * Signed numbers get a '-' in base 10 only, as in the Arduino core.
+ */
+size_t Print::print(long n, int base) {
+  if (base == DEC && n < 0) { return print('-') + printNumber(0UL - (unsigned long)n, DEC); }
+  return printNumber((unsigned long)n, base);
+} // print
+
+size_t Print::print(double n, int digits) {
+  char text[64];
+  int length = snprintf(text, sizeof(text), "%.*f", digits, n);
+
+  return (length > 0) ? write((const uint8_t *)text, min((size_t)length, sizeof(text) - 1)) : 0;
+} // print
+
+size_t Print::println()                             { return write("\r\n"); }
+size_t Print::println(const char *str)              { return print(str) + println(); }
+size_t Print::println(char c)                       { return print(c) + println(); }
+size_t Print::println(unsigned char n, int base)    { return print(n, base) + println(); }
+size_t Print::println(int n, int base)              { return print(n, base) + println(); }
+size_t Print::println(unsigned int n, int base)     { return print(n, base) + println(); }
+size_t Print::println(long n, int base)             { return print(n, base) + println(); }
+size_t Print::println(unsigned long n, int base)    { return print(n, base) + println(); }
+size_t Print::println(double n, int digits)         { return print(n, digits) + println(); }
+
+/*
+ * Digits of an unsigned number in base 2 to 36.
+ */
+size_t Print::printNumber(unsigned long n, int base) {
+  char text[8 * sizeof(unsigned long) + 1];
+  char *digit = &text[sizeof(text) - 1];
+
+  if (base < 2 || base > 36) { base = DEC; }
+  *digit = '\0';
+  do {
+    byte d = n % base;
+    *--digit = (d < 10) ? '0' + d : 'A' + d - 10;
+    n /= base;
+  } while (n > 0);
+
+  return write(digit);
+} // printNumber
+
+#endif // __linux__ && !ARDUINO
@@ -0,0 +1,83 @@
+#ifndef SER_LCD_LINUX_SHIM_H
+#define SER_LCD_LINUX_SHIM_H
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <type_traits>
+
+/*
+ * The few parts of the Arduino core that SerLCD needs, so the library builds
+ * on a Linux computer (e.g. a Raspberry Pi) and drives the display through
+ * one of the serLCD_linux_* transports with begin(SerLCDTransport&).
+ * Only included when the Arduino core isn't there.
+ */
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PGM_P const char *  //No separate program memory
+#define PSTR(s) (s)
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+//Functions rather than the core's macros, so they don't clash with std::min and std::max
+template <typename A, typename B>
+inline typename std::common_type<A, B>::type min(A a, B b) { return (b < a) ? b : a; }
+
+template <typename A, typename B>
+inline typename std::common_type<A, B>::type max(A a, B b) { return (a < b) ? b : a; }
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+/*
+ * Text output base class, as in the Arduino core: a derived class provides
+ * write(uint8_t) and gets print() and println() for strings and numbers.
+ */
+class Print {
+
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  size_t write(const char *str) { return (str == NULL) ? 0 : write((const uint8_t *)str, strlen(str)); }
+  size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+
+  size_t print(const char *str);
+  size_t print(char c);
+  size_t print(unsigned char n, int base = DEC);
+  size_t print(int n, int base = DEC);
+  size_t print(unsigned int n, int base = DEC);
+  size_t print(long n, int base = DEC);
+  size_t print(unsigned long n, int base = DEC);
+  size_t print(double n, int digits = 2);
+
+  size_t println();
+  size_t println(const char *str);
+  size_t println(char c);
+  size_t println(unsigned char n, int base = DEC);
+  size_t println(int n, int base = DEC);
+  size_t println(unsigned int n, int base = DEC);
+  size_t println(long n, int base = DEC);
+  size_t println(unsigned long n, int base = DEC);
+  size_t println(double n, int digits = 2);
+private:
+  size_t printNumber(unsigned long n, int base);
+};
+
+#endif // __linux__ && !ARDUINO
+
+#endif
@@ -0,0 +1,113 @@
+/*
+ * Linux spidev transport for the SerLCD.
+ *
+ * Usage:
+ *   SerLCDLinuxSPI spi("/dev/spidev0.0");
+ *   SerLCD lcd;
+ *   if (spi.open()) { lcd.begin(spi); }
+ */
+#ifdef __linux__
+
+#include "serLCD_linux_spi.h"
+#include "serLCD_cI2C.h"
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+
+/*
+ * char*    device - spidev node, e.g. "/dev/spidev0.0"
+ * uint32_t speed  - SPI clock in Hz
+ */
+SerLCDLinuxSPI::SerLCDLinuxSPI(const char *device, uint32_t speed) : _device(device), _speed(speed) {
+}
+
+SerLCDLinuxSPI::~SerLCDLinuxSPI() {
+  close();
+}
+
+/*
+ * Open the device node and set it up for the OpenLCD: mode 0, 8 bits, MSB first.
+ *
+ * returns: false if the node could not be opened or configured.
+ */
+bool SerLCDLinuxSPI::open() {
+  uint8_t mode = SPI_MODE_0;
+  uint8_t bits = 8;
+
+  close();
+  _fd = ::open(_device, O_RDWR | O_CLOEXEC);
+  if (_fd < 0) { return false; }
+
+  if (ioctl(_fd, SPI_IOC_WR_MODE, &mode) < 0 ||
+      ioctl(_fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+      ioctl(_fd, SPI_IOC_WR_MAX_SPEED_HZ, &_speed) < 0)
+  {
+    close();
+    return false;
+  }
+
+  return true;
+} // open
+
+/*
+ * Close the device node.
+ */
+void SerLCDLinuxSPI::close() {
+  if (_fd >= 0) {
+    ::close(_fd);
+    _fd = -1;
+  }
+} // close
+
+/*
+ * Start gathering a transaction.
+ */
+bool SerLCDLinuxSPI::beginTransmission() {
+  _length = 0;
+
+  return _fd >= 0;
+} // beginTransmission
+
+/*
+ * Add a byte to the transaction, sending what has been gathered
+ * so far if the buffer is full.
+ */
+bool SerLCDLinuxSPI::transmit(uint8_t data) {
+  if (_length == sizeof(_buffer) && !flush()) { return false; }
+
+  _buffer[_length++] = data;
+  return true;
+} // transmit
+
+/*
+ * Send the gathered transaction.
+ */
+bool SerLCDLinuxSPI::endTransmission() {
+  return flush();
+} // endTransmission
+
+/*
+ * Clock out the buffer as a single message with chip select held throughout.
+ * The kernel selects the display, waits out the enable time in an empty
+ * first transfer and then sends the data.
+ */
+bool SerLCDLinuxSPI::flush() {
+  if (_length == 0) { return true; }
+
+  struct spi_ioc_transfer transfer[2];
+  memset(transfer, 0, sizeof(transfer));
+  transfer[0].delay_usecs   = SPI_ENABLE_TIME * 1000U; //wait a bit for display to enable
+  transfer[0].speed_hz      = _speed;
+  transfer[0].bits_per_word = 8;
+  transfer[1].tx_buf        = (unsigned long)_buffer;
+  transfer[1].len           = _length;
+  transfer[1].speed_hz      = _speed;
+  transfer[1].bits_per_word = 8;
+
+  _length = 0;
+  return ioctl(_fd, SPI_IOC_MESSAGE(2), transfer) >= 0;
+} // flush
+
+#endif // __linux__
@@ -0,0 +1,43 @@
+#ifndef SER_LCD_LINUX_SPI_H
+#define SER_LCD_LINUX_SPI_H
+
+#ifdef __linux__
+
+#include "serLCD_transport.h"
+
+#define LINUX_SPI_BUFFER_SIZE 256 //Longer transactions are split into several messages
+
+/*
+ * Talks to the OpenLCD through a Linux spidev node such as /dev/spidev0.0.
+ * Each SerLCD transaction is gathered in memory and clocked out with a single
+ * SPI_IOC_MESSAGE ioctl, with chip select held by the kernel for the whole
+ * transfer, instead of a system call and chip select toggle per byte. The
+ * message starts with an empty transfer that holds chip select for the
+ * SPI_ENABLE_TIME the display needs before it takes data, as the Arduino
+ * SPI path waits after selecting it.
+ */
+class SerLCDLinuxSPI : public SerLCDTransport {
+
+public:
+  SerLCDLinuxSPI(const char *device, uint32_t speed = 100000);
+  ~SerLCDLinuxSPI();
+  bool open();
+  void close();
+  virtual int fd() const { return _fd; }
+  virtual bool beginTransmission();
+  virtual bool transmit(uint8_t data);
+  virtual bool endTransmission();
+  virtual uint8_t bitsPerByte() const { return 8; }
+  virtual uint8_t headerBytes() const { return 0; }
+private:
+  const char *_device;
+  uint32_t _speed; //Clock in Hz
+  int _fd = -1;
+  uint8_t _buffer[LINUX_SPI_BUFFER_SIZE]; //Bytes of the current transaction
+  uint16_t _length = 0;
+  bool flush();
+};
+
+#endif // __linux__
+
+#endif
@@ -0,0 +1,148 @@
+/*
+ * Interrupt-safe value mailbox for the SerLCD.
+ *
+ * Usage:
+ *   SerLCDNumberField faultCode(lcd, 16, 3, 4);
+ *   SerLCDNumberField * const fields[] = { &faultCode };
+ *   SerLCDMailbox mailbox(fields, 1);
+ *   mailbox.start(lcd);
+ *   ...
+ *   ISR(INT0_vect) { mailbox.post(0, readFault()); }
+ *   ...
+ *   loop() { lcd.service(); }
+ */
+#include "serLCD_mailbox.h"
+
+#ifdef __AVR__
+#include <util/atomic.h>
+#elif defined(__ARM_ARCH_6M__)
+//No atomic read-modify-write on ARMv6-M (SAMD21, RP2040), and the Arduino cores
+//lack the libatomic calls GCC would use instead; mask interrupts like ATOMIC_BLOCK
+static inline void pendingOr(volatile byte &pending, byte bits) {
+  uint32_t primask;
+  __asm__ __volatile__("mrs %0, primask\n\tcpsid i" : "=r" (primask) :: "memory");
+  pending |= bits;
+  __asm__ __volatile__("msr primask, %0" :: "r" (primask) : "memory");
+}
+
+static inline void pendingAnd(volatile byte &pending, byte bits) {
+  uint32_t primask;
+  __asm__ __volatile__("mrs %0, primask\n\tcpsid i" : "=r" (primask) :: "memory");
+  pending &= bits;
+  __asm__ __volatile__("msr primask, %0" :: "r" (primask) : "memory");
+}
+#else
+static inline void pendingOr(volatile byte &pending, byte bits) {
+  __atomic_fetch_or(&pending, bits, __ATOMIC_ACQ_REL);
+}
+
+static inline void pendingAnd(volatile byte &pending, byte bits) {
+  __atomic_fetch_and(&pending, bits, __ATOMIC_ACQ_REL);
+}
+#endif
+
+/*
+ * SerLCDNumberField*[] fields - fields that values are posted to, by index
+ * byte                 count  - number of fields, at most MAILBOX_SIZE
+ */
+SerLCDMailbox::SerLCDMailbox(SerLCDNumberField * const *fields, byte count) : _fields(fields) {
+  _count = min(count, MAILBOX_SIZE);
+}
+
+/*
+ * Attach the mailbox to a display. While nothing is pending, service()
+ * only checks it every pollInterval ms. Turns on deferred settling, so
+ * service() doesn't wait out the pause after each update.
+ */
+void SerLCDMailbox::start(SerLCD &lcd, unsigned int pollInterval) {
+  _pollInterval = pollInterval;
+  lcd.deferSettling(true);
+  lcd.attach(*this);
+  schedule(millis());
+} // start
+
+/*
+ * Post a value for a field. Safe to call from an interrupt handler:
+ * it does not allocate, block or touch the bus.
+ *
+ * byte id    - index of the field
+ * long value - value to show
+ *
+ * returns: false if there is no such field.
+ */
+bool SerLCDMailbox::post(byte id, long value) {
+  if (id >= _count) { return false; }
+
+#ifdef __AVR__
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    _values[id] = value;
+    _pending |= (1 << id);
+  }
+#else
+  __atomic_store_n(&_values[id], value, __ATOMIC_RELAXED);
+  pendingOr(_pending, 1 << id);
+#endif
+  return true;
+} // post
+
+/*
+ * Bytes needed to render the next pending value: the field plus one
+ * address command, see SerLCD::update().
+ */
+byte SerLCDMailbox::cost() const {
+  byte pending = _pending;
+
+  for (byte id = 0; id < _count; id++) {
+    if (pending & (1 << id)) { return _fields[id]->width() + 2; }
+  } // for
+
+  return 0;
+} // cost
+
+/*
+ * Render one pending value and schedule the next check.
+ */
+bool SerLCDMailbox::run(SerLCD &lcd, unsigned long now) {
+  byte pending;
+#ifdef __AVR__
+  pending = _pending;
+#else
+  pending = __atomic_load_n(&_pending, __ATOMIC_ACQUIRE);
+#endif
+
+  if (pending == 0) {
+    schedule(now + _pollInterval);
+    return true;
+  }
+
+  byte id = 0;
+  while (!(pending & (1 << id))) { id++; }
+
+  //Take the value and clear its flag together, so a newer post is never lost
+  long value;
+#ifdef __AVR__
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    value = _values[id];
+    _pending &= ~(1 << id);
+  }
+#else
+  pendingAnd(_pending, ~(1 << id));
+  value = __atomic_load_n(&_values[id], __ATOMIC_RELAXED);
+#endif
+
+  schedule(now);
+  bool ok = _fields[id]->set(value);
+
+  //Cut short by service(budget): flag the field again. Its slot still holds
+  //this value, or a newer one if one was posted meanwhile.
+  if (ok && lcd.truncated()) {
+#ifdef __AVR__
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      _pending |= (1 << id);
+    }
+#else
+    pendingOr(_pending, 1 << id);
+#endif
+  }
+  return ok;
+} // run
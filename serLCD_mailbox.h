@@ -0,0 +1,30 @@
+#ifndef SER_LCD_MAILBOX_H
+#define SER_LCD_MAILBOX_H
+
+#include "serLCD_field.h"
+
+#define MAILBOX_SIZE 8 //Fields one mailbox can serve
+
+/*
+ * Lets an interrupt handler put a value on the display. post() only stores
+ * the value in the field's slot and flags it; nothing is formatted or sent
+ * until SerLCD::service() renders it through the field in the main loop.
+ * A value posted again before it is rendered simply replaces the old one.
+ */
+class SerLCDMailbox : public SerLCDTask {
+
+public:
+  SerLCDMailbox(SerLCDNumberField * const *fields, byte count);
+  void start(SerLCD &lcd, unsigned int pollInterval = 10);
+  bool post(byte id, long value);
+  virtual bool run(SerLCD &lcd, unsigned long now);
+  virtual byte cost() const;
+private:
+  SerLCDNumberField * const *_fields;
+  byte _count;
+  volatile long _values[MAILBOX_SIZE]; //Latest value posted for each field
+  volatile byte _pending = 0;          //Bit set for each field with a value to render
+  unsigned int _pollInterval = 10;     //Time between checks when nothing is pending in ms
+};
+
+#endif
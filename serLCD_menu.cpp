@@ -0,0 +1,101 @@
+/*
+ * Scrolling menu for the SerLCD.
+ *
+ * Usage:
+ *   const char * const items[] = { "Setpoint", "Alarms", "Network", ... };
+ *   SerLCDMenu menu(lcd, items, sizeof(items) / sizeof(items[0]), 1, 3); //Rows 1 to 3
+ *   menu.show();
+ *   ...
+ *   if (downPressed) { menu.next(); }
+ *   if (enterPressed) { open(menu.selected()); }
+ */
+#include "serLCD_menu.h"
+
+/*
+ * SerLCD lcd      - display the menu is shown on
+ * char*[] items   - item texts
+ * byte   count    - number of items
+ * byte   firstRow - top row of the menu
+ * byte   rows     - number of rows the menu uses
+ */
+SerLCDMenu::SerLCDMenu(SerLCD &lcd, const char * const *items, byte count, byte firstRow, byte rows)
+  : _lcd(&lcd), _items(items), _count(count) {
+  //keep the menu on the display
+  _firstRow = min(firstRow, MAX_ROWS - 1);
+  _rows     = max(1, min(rows, MAX_ROWS - _firstRow));
+}
+
+/*
+ * Change the character used to mark the selected item. Takes effect when the menu is next drawn.
+ */
+void SerLCDMenu::setMarker(char marker) {
+  _marker = marker;
+} // setMarker
+
+/*
+ * Draw the visible part of the menu.
+ */
+bool SerLCDMenu::show() {
+  for (byte r = 0; r < _rows; r++) {
+    if (!drawRow(r)) { return false; }
+  } // for
+
+  return true;
+} // show
+
+/*
+ * Move the selection down one item, scrolling if needed.
+ */
+bool SerLCDMenu::next() {
+  if (_selected + 1 >= _count) { return true; }
+
+  return select(_selected + 1);
+} // next
+
+/*
+ * Move the selection up one item, scrolling if needed.
+ */
+bool SerLCDMenu::previous() {
+  if (_selected == 0) { return true; }
+
+  return select(_selected - 1);
+} // previous
+
+/*
+ * Select an item, scrolling it into view if needed.
+ */
+bool SerLCDMenu::select(byte index) {
+  if (index >= _count) { return false; }
+
+  byte old = _selected;
+  _selected = index;
+
+  //Still in view: only the marker moves
+  if (index >= _top && index < _top + _rows) {
+    return drawRow(old - _top) && drawRow(index - _top);
+  }
+
+  if (index < _top) { _top = index; }
+  else              { _top = index - _rows + 1; }
+
+  return show();
+} // select
+
+/*
+ * Draw one visible row, r counting from the first row of the menu.
+ * Rows of items that are not in view are ignored.
+ */
+bool SerLCDMenu::drawRow(byte r) {
+  if (r >= _rows) { return true; }
+
+  char line[MAX_COLUMNS + 1] = "";
+  byte item = _top + r;
+
+  if (item < _count) {
+    line[0] = (item == _selected) ? _marker : ' ';
+    strncpy(line + 1, _items[item], MAX_COLUMNS - 1);
+    line[MAX_COLUMNS] = '\0';
+  }
+
+  return _lcd->update(0, _firstRow + r, line, MAX_COLUMNS);
+} // drawRow
@@ -0,0 +1,34 @@
+#ifndef SER_LCD_MENU_H
+#define SER_LCD_MENU_H
+
+#include "serLCD_cI2C.h"
+
+/*
+ * A scrolling menu of text items in a range of rows. The first column holds
+ * the selection marker. Moving the selection within the visible rows only
+ * rewrites the two marker cells; scrolling redraws the rows through
+ * SerLCD::update(), so text shared between items is not sent again.
+ */
+class SerLCDMenu {
+
+public:
+  SerLCDMenu(SerLCD &lcd, const char * const *items, byte count, byte firstRow = 0, byte rows = MAX_ROWS);
+  void setMarker(char marker);
+  bool show();
+  bool next();
+  bool previous();
+  bool select(byte index);
+  byte selected() const { return _selected; }
+private:
+  SerLCD *_lcd;
+  const char * const *_items;
+  byte _count;
+  byte _firstRow;
+  byte _rows;
+  byte _top = 0;      //Item shown in the first row
+  byte _selected = 0;
+  char _marker = '>';
+  bool drawRow(byte r);
+};
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * TCA9548A multiplexer support for the SerLCD.
+ *
+ * Usage:
+ *   SerLCDMux mux;
+ *   SerLCD panels[8];
+ *   for (byte i = 0; i < 8; i++) { panels[i].begin(i2c, DISPLAY_ADDRESS1, mux, i); }
+ */
+#include "serLCD_mux.h"
+
+#ifdef ARDUINO
+
+/*
+ * byte address - I2C address of the mux, 0x70 to 0x77
+ */
+SerLCDMux::SerLCDMux(byte address) : _address(address) {
+}
+
+/*
+ * Route the bus to a channel, unless it is already selected.
+ *
+ * I2C  port    - bus the mux is on
+ * byte channel - channel 0 to 7
+ *
+ * returns: false if the mux could not be reached.
+ */
+bool SerLCDMux::select(I2C &port, byte channel) {
+  channel &= 0x7; // the mux only has 8 channels 0-7
+  if (channel == _channel) { return true; }
+
+  if (port.beginTransmission(_address, true, false) == I2C_STATUS_OK &&
+      port.transmit(1 << channel) == I2C_STATUS_OK &&   //One bit per channel
+      port.endTransmission() == I2C_STATUS_OK)
+  {
+    _channel = channel;
+    return true;
+  }
+  else {
+    _channel = MUX_NO_CHANNEL; //The mux may or may not have switched
+    return false;
+  }
+} // select
+
+/*
+ * Forget the selected channel, e.g. after other code used the mux directly,
+ * so the next select() always switches.
+ */
+void SerLCDMux::invalidate() {
+  _channel = MUX_NO_CHANNEL;
+} // invalidate
+
+#endif // ARDUINO
@@ -0,0 +1,32 @@
+#ifndef SER_LCD_MUX_H
+#define SER_LCD_MUX_H
+
+#ifdef ARDUINO //Works with the I2C library's ports
+
+#include <Arduino.h>
+#include <I2C.h>
+
+#define MUX_ADDRESS      0x70 //Default address of the TCA9548A
+#define MUX_NO_CHANNEL   0xFF //Channel selection not known
+
+/*
+ * A TCA9548A I2C multiplexer shared by the displays behind it. The mux
+ * remembers which channel it last selected, so switching is only done when
+ * a display on a different channel is addressed. Use one SerLCDMux object
+ * per physical mux and pass it to every SerLCD behind it.
+ */
+class SerLCDMux {
+
+public:
+  SerLCDMux(byte address = MUX_ADDRESS);
+  bool select(I2C &port, byte channel);
+  void invalidate();
+  byte channel() const { return _channel; }
+private:
+  byte _address;
+  byte _channel = MUX_NO_CHANNEL; //Channel currently selected
+};
+
+#endif // ARDUINO
+
+#endif
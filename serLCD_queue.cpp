@@ -0,0 +1,274 @@
+/*
+ * Multi-producer update queue for the SerLCD.
+ *
+ * Usage:
+ *   SerLCDQueue updates;
+ *   updates.start(lcd);
+ *   ...
+ *   updates.post(0, 2, "Door open"); //From any thread or ISR
+ *   ...
+ *   loop() { lcd.service(); }        //The only place the display is written
+ *
+ * The queue is a bounded ring in which each slot carries a sequence number
+ * (after Dmitry Vyukov's bounded queue): a producer claims a slot by advancing
+ * the enqueue position with compare-and-swap, fills it, and then publishes it
+ * by bumping the slot's sequence. On AVR and Cortex-M0/M0+ (SAMD21, RP2040)
+ * the compare-and-swap is done with interrupts briefly disabled, which is
+ * atomic on a single core; on the dual-core RP2040 post only from the core
+ * that runs service().
+ */
+#include "serLCD_queue.h"
+
+#ifdef __AVR__
+#include <util/atomic.h>
+
+//Single byte accesses are atomic; the barrier keeps the compiler from reordering around them
+static inline queue_index_t loadAcquire(const volatile queue_index_t &value) {
+  queue_index_t result = value;
+  __asm__ __volatile__("" ::: "memory");
+  return result;
+}
+
+static inline void storeRelease(volatile queue_index_t &value, queue_index_t result) {
+  __asm__ __volatile__("" ::: "memory");
+  value = result;
+}
+
+static inline bool compareAndSwap(volatile queue_index_t &value, queue_index_t &expected, queue_index_t desired) {
+  bool swapped = false;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (value == expected) {
+      value = desired;
+      swapped = true;
+    }
+    else { expected = value; }
+  }
+  return swapped;
+}
+#elif defined(__ARM_ARCH_6M__)
+//No exclusive load/store on ARMv6-M, so GCC would turn the __atomic read-modify-write
+//builtins into libatomic calls, which the Arduino cores don't provide
+
+//Aligned word accesses are atomic; the barrier orders them like acquire/release
+static inline queue_index_t loadAcquire(const volatile queue_index_t &value) {
+  queue_index_t result = value;
+  __asm__ __volatile__("dmb" ::: "memory");
+  return result;
+}
+
+static inline void storeRelease(volatile queue_index_t &value, queue_index_t result) {
+  __asm__ __volatile__("dmb" ::: "memory");
+  value = result;
+}
+
+static inline bool compareAndSwap(volatile queue_index_t &value, queue_index_t &expected, queue_index_t desired) {
+  bool swapped = false;
+  uint32_t primask;
+
+  __asm__ __volatile__("mrs %0, primask\n\tcpsid i" : "=r" (primask) :: "memory"); //Save and disable interrupts
+  if (value == expected) {
+    value = desired;
+    swapped = true;
+  }
+  else { expected = value; }
+  __asm__ __volatile__("msr primask, %0" :: "r" (primask) : "memory");              //Restore them
+  return swapped;
+}
+#else
+static inline queue_index_t loadAcquire(const volatile queue_index_t &value) {
+  return __atomic_load_n(&value, __ATOMIC_ACQUIRE);
+}
+
+static inline void storeRelease(volatile queue_index_t &value, queue_index_t result) {
+  __atomic_store_n(&value, result, __ATOMIC_RELEASE);
+}
+
+static inline bool compareAndSwap(volatile queue_index_t &value, queue_index_t &expected, queue_index_t desired) {
+  return __atomic_compare_exchange_n(&value, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+#endif
+
+//<<constructor>>
+SerLCDQueue::SerLCDQueue() {
+  for (queue_index_t i = 0; i < QUEUE_SIZE; i++) {
+    _slots[i].sequence = i;
+    _slots[i].lock = 0;
+  } // for
+}
+
+/*
+ * Attach the queue to a display. While the queue is empty, service()
+ * only checks it every pollInterval ms. Turns on deferred settling, so
+ * service() doesn't wait out the pause after each update.
+ */
+void SerLCDQueue::start(SerLCD &lcd, unsigned int pollInterval) {
+  _pollInterval = pollInterval;
+  lcd.deferSettling(true);
+  lcd.attach(*this);
+  schedule(millis());
+} // start
+
+/*
+ * Try to take the lock of a slot, without waiting.
+ */
+static inline bool tryLock(volatile queue_index_t &lock) {
+  queue_index_t unlocked = 0;
+  return compareAndSwap(lock, unlocked, 1);
+}
+
+/*
+ * Queue an update of a field of a row, see SerLCD::update().
+ * Safe to call from any thread or interrupt; never blocks. If an update of
+ * the same field (col, row and width) is still waiting, its text is
+ * replaced instead of queueing another, as long as the new text covers
+ * the same cells and no later waiting update overlaps them; otherwise the
+ * newer text would be shown before, and under, that later update.
+ *
+ * returns: false if the queue is full and the update was dropped.
+ */
+bool SerLCDQueue::post(byte col, byte row, const char *text, byte width) {
+  if (text == NULL) { text = ""; }
+
+  for (queue_index_t i = 0; i < QUEUE_SIZE; i++) {
+    Update *waiting = &_slots[i];
+    queue_index_t pos;
+    if (!tryLock(waiting->lock)) { continue; } //Being sent or replaced right now
+
+    bool replace = waitingAt(i, pos) &&
+                   waiting->col == col && waiting->row == row && waiting->width == width &&
+                   cells(*waiting, text) >= cells(*waiting, waiting->text) &&
+                   !overtaken(i, pos);
+    if (replace) {
+      strncpy(waiting->text, text, MAX_COLUMNS);
+      waiting->text[MAX_COLUMNS] = '\0';
+    }
+    storeRelease(waiting->lock, 0);
+
+    if (replace) { return true; }
+  } // for
+
+  queue_index_t pos = loadAcquire(_enqueuePos);
+  Update *slot;
+
+  while (true) {
+    slot = &_slots[pos & (QUEUE_SIZE - 1)];
+    queue_index_t sequence = loadAcquire(slot->sequence);
+
+    //The slot is free for this position: try to claim it
+    if (sequence == pos) {
+      if (compareAndSwap(_enqueuePos, pos, (queue_index_t)(pos + 1))) { break; }
+    }
+    //The slot still holds an update from one lap ago: full
+    else if ((queue_index_t)(sequence - pos) > (queue_index_t)(pos - sequence)) {
+      return false;
+    }
+    //Another producer claimed it first
+    else {
+      pos = loadAcquire(_enqueuePos);
+    }
+  } // while
+
+  slot->col = col;
+  slot->row = row;
+  slot->width = width;
+  strncpy(slot->text, text, MAX_COLUMNS);
+  slot->text[MAX_COLUMNS] = '\0';
+
+  storeRelease(slot->sequence, pos + 1);
+  return true;
+} // post
+
+/*
+ * Whether a slot holds an update waiting to be sent, and its position in
+ * the queue: a waiting slot's sequence is one past its position.
+ */
+bool SerLCDQueue::waitingAt(queue_index_t i, queue_index_t &pos) const {
+  pos = loadAcquire(_slots[i].sequence) - 1;
+  return (pos & (QUEUE_SIZE - 1)) == i;
+} // waitingAt
+
+/*
+ * Whether an update queued after the one at pos, in slot i, overlaps its
+ * cells. A slot that is locked by someone else counts as overlapping,
+ * since it can't be read safely.
+ */
+bool SerLCDQueue::overtaken(queue_index_t i, queue_index_t pos) {
+  const Update &update = _slots[i];
+  byte first = update.col;
+  byte last = first + cells(update, update.text); //One past the last cell
+
+  for (queue_index_t j = 0; j < QUEUE_SIZE; j++) {
+    Update &later = _slots[j];
+    queue_index_t laterPos;
+    if (j == i) { continue; }
+    if (!tryLock(later.lock)) { return true; }
+
+    bool overlaps = waitingAt(j, laterPos) && (queue_index_t)(laterPos - pos) < QUEUE_SIZE &&
+                    later.row == update.row &&
+                    later.col < last && first < later.col + cells(later, later.text);
+    storeRelease(later.lock, 0);
+
+    if (overlaps) { return true; }
+  } // for
+
+  return false;
+} // overtaken
+
+/*
+ * Cells an update covers with a given text: its width, or the length of
+ * the text if it has none, clipped at the end of the row.
+ */
+byte SerLCDQueue::cells(const Update &update, const char *text) {
+  byte width = update.width ? update.width : strlen(text);
+  return min(width, MAX_COLUMNS - min(update.col, MAX_COLUMNS));
+} // cells
+
+/*
+ * Bytes needed for the oldest update. SerLCD::update() never sends more than
+ * the field plus one address command, since it only jumps over gaps of three
+ * or more cells.
+ */
+byte SerLCDQueue::cost() const {
+  const Update *slot = &_slots[_dequeuePos & (QUEUE_SIZE - 1)];
+
+  if (loadAcquire(slot->sequence) != (queue_index_t)(_dequeuePos + 1)) { return 0; }
+
+  byte width = slot->width ? slot->width : strlen(slot->text);
+  return min(width, MAX_COLUMNS) + 2;
+} // cost
+
+/*
+ * Send the oldest update, if any, and schedule the next check.
+ */
+bool SerLCDQueue::run(SerLCD &lcd, unsigned long now) {
+  Update *slot = &_slots[_dequeuePos & (QUEUE_SIZE - 1)];
+
+  if (loadAcquire(slot->sequence) != (queue_index_t)(_dequeuePos + 1)) {
+    schedule(now + _pollInterval);
+    return true;
+  }
+
+  //A producer is replacing the text; try again on the next call
+  if (!tryLock(slot->lock)) {
+    schedule(now);
+    return true;
+  }
+
+  bool ok = lcd.update(slot->col, slot->row, slot->text, slot->width);
+
+  //Cut short by service(budget): keep the slot and send the rest next time,
+  //or the newer text if the update is replaced meanwhile
+  if (ok && lcd.truncated()) {
+    storeRelease(slot->lock, 0);
+    schedule(now);
+    return true;
+  }
+
+  //Hand the slot back to producers for the next lap
+  storeRelease(slot->sequence, _dequeuePos + QUEUE_SIZE);
+  storeRelease(slot->lock, 0);
+  _dequeuePos++;
+
+  schedule(now);
+  return ok;
+} // run
@@ -0,0 +1,53 @@
+#ifndef SER_LCD_QUEUE_H
+#define SER_LCD_QUEUE_H
+
+#include "serLCD_cI2C.h"
+
+#ifndef QUEUE_SIZE
+#define QUEUE_SIZE 8 //Updates that can wait at once, must be a power of 2 up to 64
+#endif
+
+//Counters small enough to be read and written atomically by the processor
+#ifdef __AVR__
+typedef uint8_t queue_index_t;
+#else
+typedef unsigned int queue_index_t;
+#endif
+
+/*
+ * A thread- and interrupt-safe front end for a display. Any number of
+ * producers (threads, ISRs, the main loop) post text updates into a
+ * lock-free bounded queue without blocking; the queue is a SerLCDTask, so
+ * the single consumer is SerLCD::service(), which sends one update per call
+ * through SerLCD::update(). Producers never touch the bus, so transactions
+ * can't interleave. An update for a field that already has one waiting
+ * replaces its text, so a burst of values leaves only the newest queued,
+ * unless a later update in the queue overlaps the field.
+ */
+class SerLCDQueue : public SerLCDTask {
+
+public:
+  SerLCDQueue();
+  void start(SerLCD &lcd, unsigned int pollInterval = 10);
+  bool post(byte col, byte row, const char *text, byte width = 0);
+  virtual bool run(SerLCD &lcd, unsigned long now);
+  virtual byte cost() const;
+private:
+  struct Update {
+    volatile queue_index_t sequence; //Tells producers and the consumer whose turn the slot is
+    volatile queue_index_t lock;     //Held while a waiting update is read or replaced
+    byte col;
+    byte row;
+    byte width;
+    char text[MAX_COLUMNS + 1];
+  };
+  Update _slots[QUEUE_SIZE];
+  volatile queue_index_t _enqueuePos = 0; //Next slot a producer claims
+  queue_index_t _dequeuePos = 0;          //Next slot the consumer reads, only touched by run()
+  unsigned int _pollInterval = 10;        //Time between checks of an empty queue in ms
+  bool waitingAt(queue_index_t i, queue_index_t &pos) const;
+  bool overtaken(queue_index_t i, queue_index_t pos);
+  static byte cells(const Update &update, const char *text);
+};
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * Non-blocking command sequences for the SerLCD.
+ *
+ * Usage:
+ *   SerLCDStartSequence startup(0x00FF00, icons, 4);
+ *   lcd.deferSettling(true);
+ *   lcd.begin(i2c);
+ *   startup.start(lcd);
+ *   ...
+ *   loop() { lcd.service(); }  //startup.running() is false once it is done
+ *
+ * A sequence of your own:
+ *   byte Blink::step(SerLCD &lcd) {
+ *     SEQUENCE_BEGIN();
+ *     for (_count = 0; _count < 3; _count++) {
+ *       SEQUENCE_SEND(lcd.noDisplay());
+ *       SEQUENCE_SEND(lcd.display());
+ *     }
+ *     SEQUENCE_END();
+ *   }
+ *
+ * The sequences are plain resumable state machines, so they work on AVR
+ * compilers without C++20 coroutine support. Where the compiler has it, the
+ * same can be written as a coroutine (see SerLCDRoutine):
+ *   SerLCDRoutine blink(SerLCD &lcd) {
+ *     for (int i = 0; i < 3; i++) {
+ *       SEQUENCE_CO_SEND(lcd.noDisplay());
+ *       SEQUENCE_CO_SEND(lcd.display());
+ *     }
+ *     co_return true;
+ *   }
+ *   SerLCDRoutine blinking = blink(lcd);
+ *   blinking.start(lcd);
+ */
+#include "serLCD_sequence.h"
+
+/*
+ * Attach the sequence to a display and run it from the beginning on the next
+ * service(). Turns on deferred settling, which the sequence relies on.
+ */
+void SerLCDSequence::start(SerLCD &lcd) {
+  _resumePoint = 0;
+  _result = SEQUENCE_RUNNING;
+  lcd.deferSettling(true);
+  lcd.attach(*this);
+  schedule(millis());
+} // start
+
+/*
+ * Resume the sequence; it is called again on the next service() until it
+ * is done. service() holds it back while the display is settling.
+ */
+bool SerLCDSequence::run(SerLCD &lcd, unsigned long now) {
+  _result = step(lcd);
+  if (_result == SEQUENCE_RUNNING) { schedule(now); }
+
+  return _result != SEQUENCE_FAILED;
+} // run
+
+/*
+ * unsigned long rgb        - backlight colour as 0x00RRGGBB
+ * byte[][8]     glyphs     - custom characters for slots 0 onwards, or NULL
+ * byte          glyphCount - number of custom characters
+ */
+SerLCDStartSequence::SerLCDStartSequence(unsigned long rgb, const byte (*glyphs)[8], byte glyphCount)
+  : _rgb(rgb), _glyphs(glyphs), _glyphCount(min(glyphCount, 8)) {
+}
+
+byte SerLCDStartSequence::step(SerLCD &lcd) {
+  SEQUENCE_BEGIN();
+  SEQUENCE_SEND(lcd.clear());
+  SEQUENCE_SEND(lcd.setBacklight(_rgb));
+
+  for (_glyph = 0; _glyph < _glyphCount; _glyph++) {
+    SEQUENCE_SEND(lcd.createChar(_glyph, _glyphs[_glyph]));
+  } // for
+
+  SEQUENCE_END();
+} // step
@@ -0,0 +1,145 @@
+#ifndef SER_LCD_SEQUENCE_H
+#define SER_LCD_SEQUENCE_H
+
+#include "serLCD_cI2C.h"
+
+//Results of SerLCDSequence::step()
+#define SEQUENCE_RUNNING 0
+#define SEQUENCE_DONE    1
+#define SEQUENCE_FAILED  2
+
+//Marks the deliberate fall through into a resume point; a /* fall through */
+//comment would not survive macro expansion
+#if defined(__clang__)
+#define SEQUENCE_FALLTHROUGH [[clang::fallthrough]]
+#elif defined(__GNUC__) && __GNUC__ >= 7
+#define SEQUENCE_FALLTHROUGH __attribute__((fallthrough))
+#else
+#define SEQUENCE_FALLTHROUGH
+#endif
+
+/*
+ * Protothread-style macros for writing step(). The body reads like the
+ * blocking calls it replaces, but every SEQUENCE_SEND() returns to the main
+ * loop until the display has settled from the previous command, and picks up
+ * where it left off on the next call. Local variables don't survive a
+ * yield; keep state in members. The SerLCD parameter must be named lcd.
+ */
+#define SEQUENCE_BEGIN()     switch (_resumePoint) { case 0:
+#define SEQUENCE_AWAIT(cond) _resumePoint = __LINE__; SEQUENCE_FALLTHROUGH; case __LINE__: if (!(cond)) { return SEQUENCE_RUNNING; }
+#define SEQUENCE_SEND(call)  SEQUENCE_AWAIT(lcd.ready()); if (!(call)) { _resumePoint = 0; return SEQUENCE_FAILED; }
+#define SEQUENCE_END()       } _resumePoint = 0; return SEQUENCE_DONE;
+
+/*
+ * A multi-step display operation that never waits in delay(). Derived
+ * classes write step() with the macros above; the sequence is a SerLCDTask,
+ * so service() resumes it whenever the display is ready.
+ */
+class SerLCDSequence : public SerLCDTask {
+
+public:
+  void start(SerLCD &lcd);
+  bool running() const { return _result == SEQUENCE_RUNNING && scheduled(); }
+  byte result() const { return _result; }
+  virtual byte step(SerLCD &lcd) = 0;
+  virtual bool run(SerLCD &lcd, unsigned long now);
+protected:
+  unsigned int _resumePoint = 0; //Where step() continues, 0 for the beginning
+private:
+  byte _result = SEQUENCE_DONE;
+};
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define SEQUENCE_COROUTINES 1 //C++20 coroutines are available, see SerLCDRoutine
+#endif
+#endif
+
+#ifdef SEQUENCE_COROUTINES
+#include <coroutine>
+
+/*
+ * Awaited by a SerLCDRoutine before each command: suspends the coroutine
+ * until service() finds the display ready, or goes straight on if it is.
+ */
+struct SerLCDSettled {
+  SerLCD &lcd;
+  bool await_ready() const { return lcd.ready(); }
+  void await_suspend(std::coroutine_handle<>) const {}
+  void await_resume() const {}
+};
+
+//Like SEQUENCE_SEND(), in a SerLCDRoutine
+#define SEQUENCE_CO_SEND(call) do { co_await SerLCDSettled{lcd}; if (!(call)) { co_return false; } } while (0)
+
+/*
+ * The C++20 coroutine front end to SerLCDSequence, for hosts whose compiler
+ * supports it; AVR builds only get the macros above. A function returning
+ * SerLCDRoutine is written with plain locals and loops, waits for the display
+ * with SEQUENCE_CO_SEND() and ends with co_return true, or false on failure.
+ * Calling it only creates the coroutine; start() attaches it like a
+ * sequence and service() resumes it whenever the display is ready. Kept in
+ * the header so the library itself doesn't need C++20.
+ */
+class SerLCDRoutine : public SerLCDTask {
+
+public:
+  struct promise_type {
+    byte result = SEQUENCE_RUNNING;
+    SerLCDRoutine get_return_object() { return SerLCDRoutine(std::coroutine_handle<promise_type>::from_promise(*this)); }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_value(bool ok) { result = ok ? SEQUENCE_DONE : SEQUENCE_FAILED; }
+    void unhandled_exception() { result = SEQUENCE_FAILED; }
+  };
+
+  SerLCDRoutine(SerLCDRoutine &&other) noexcept : SerLCDTask(other), _handle(other._handle) { other._handle = nullptr; }
+  SerLCDRoutine(const SerLCDRoutine &) = delete;
+  ~SerLCDRoutine() { if (_handle) { _handle.destroy(); } }
+
+  /*
+   * Attach the routine to a display and run it on the next service().
+   * Turns on deferred settling, which the routine relies on.
+   */
+  void start(SerLCD &lcd) {
+    lcd.deferSettling(true);
+    lcd.attach(*this);
+    schedule(millis());
+  }
+
+  bool running() const { return _handle && !_handle.done() && scheduled(); }
+  byte result() const { return _handle ? _handle.promise().result : (byte)SEQUENCE_FAILED; }
+
+  /*
+   * Resume the coroutine up to its next wait for the display.
+   */
+  virtual bool run(SerLCD &, unsigned long now) {
+    if (!_handle || _handle.done()) { return true; }
+
+    _handle.resume();
+    if (!_handle.done()) { schedule(now); }
+    return _handle.promise().result != SEQUENCE_FAILED;
+  }
+private:
+  explicit SerLCDRoutine(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+  std::coroutine_handle<promise_type> _handle;
+};
+#endif // SEQUENCE_COROUTINES
+
+/*
+ * Brings a display to a known state without blocking: clears it, sets the
+ * backlight colour and uploads a set of custom characters.
+ */
+class SerLCDStartSequence : public SerLCDSequence {
+
+public:
+  SerLCDStartSequence(unsigned long rgb, const byte (*glyphs)[8] = NULL, byte glyphCount = 0);
+  virtual byte step(SerLCD &lcd);
+private:
+  unsigned long _rgb;
+  const byte (*_glyphs)[8];
+  byte _glyphCount;
+  byte _glyph = 0; //Next glyph to upload
+};
+
+#endif
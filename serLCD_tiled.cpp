@@ -0,0 +1,174 @@
+/*
+ * Virtual screen spanning several SerLCDs.
+ *
+ * Usage:
+ *   char screen[40 * 4];
+ *   SerLCDTiledDisplay wall(screen, 40, 4);
+ *   wall.addTile(left, 0, 0);
+ *   wall.addTile(right, 20, 0);
+ *   ...
+ *   wall.setCursor(15, 1);
+ *   wall.print("Across the seam");
+ *   wall.refresh();
+ */
+#include "serLCD_tiled.h"
+
+/*
+ * buffer - cols * rows characters for the framebuffer, owned by the caller
+ * cols   - width of the virtual screen
+ * rows   - height of the virtual screen
+ */
+SerLCDTiledDisplay::SerLCDTiledDisplay(char *buffer, byte cols, byte rows)
+  : _buffer(buffer), _cols(cols), _rows(rows) {
+  memset(_buffer, ' ', (unsigned int)_cols * _rows);
+}
+
+/*
+ * Show part of the virtual screen on a display. The tile is clipped to the
+ * virtual screen, and is shown in full on the next refresh().
+ *
+ * lcd  - display, already begun
+ * col  - column of the virtual screen shown in the display's first column
+ * row  - row of the virtual screen shown in the display's first row
+ * cols - columns of the display, up to 20
+ * rows - rows of the display, up to 4
+ *
+ * returns: false if there is no room for another tile or it lies off screen.
+ */
+bool SerLCDTiledDisplay::addTile(SerLCD &lcd, byte col, byte row, byte cols, byte rows) {
+  if (_tileCount >= TILED_MAX_TILES || col >= _cols || row >= _rows) { return false; }
+
+  Tile &tile = _tiles[_tileCount++];
+  tile.lcd  = &lcd;
+  tile.col  = col;
+  tile.row  = row;
+  tile.cols = min(min(cols, (byte)MAX_COLUMNS), (byte)(_cols - col));
+  tile.rows = min(min(rows, (byte)MAX_ROWS), (byte)(_rows - row));
+  tile.dirty = (1 << tile.rows) - 1;
+  return true;
+} // addTile
+
+/*
+ * Write a character at the virtual cursor. '\n' moves to the start of the
+ * next row; text running past the end of a row continues on the next one,
+ * and the bottom row wraps to the top. Nothing is sent until refresh().
+ */
+size_t SerLCDTiledDisplay::write(uint8_t c) {
+  if (c == '\r') { return 1; }
+
+  if (c == '\n') {
+    _col = 0;
+    _row = (_row + 1) % _rows;
+    return 1;
+  }
+
+  char &cell = _buffer[(unsigned int)_row * _cols + _col];
+  if (cell != (char)c) {
+    cell = c;
+    markDirty(_col, _row);
+  }
+
+  if (++_col >= _cols) {
+    _col = 0;
+    _row = (_row + 1) % _rows;
+  }
+  return 1;
+} // write
+
+/*
+ * Move the virtual cursor.
+ *
+ * col - column on the virtual screen
+ * row - row on the virtual screen
+ */
+void SerLCDTiledDisplay::setCursor(byte col, byte row) {
+  _col = min(col, (byte)(_cols - 1));
+  _row = min(row, (byte)(_rows - 1));
+} // setCursor
+
+/*
+ * Blank the virtual screen and home the cursor. Only the displays that
+ * showed something are sent the change on refresh().
+ */
+void SerLCDTiledDisplay::clear() {
+  for (byte row = 0; row < _rows; row++) {
+    for (byte col = 0; col < _cols; col++) {
+      char &cell = _buffer[(unsigned int)row * _cols + col];
+      if (cell != ' ') {
+        cell = ' ';
+        markDirty(col, row);
+      }
+    } // for
+  } // for
+
+  _col = 0;
+  _row = 0;
+} // clear
+
+/*
+ * The character in a cell of the virtual screen, ' ' if off screen.
+ */
+char SerLCDTiledDisplay::charAt(byte col, byte row) const {
+  if (col >= _cols || row >= _rows) { return ' '; }
+  return _buffer[(unsigned int)row * _cols + col];
+} // charAt
+
+/*
+ * Whether any tile has changes not yet sent.
+ */
+bool SerLCDTiledDisplay::dirty() const {
+  for (byte i = 0; i < _tileCount; i++) {
+    if (_tiles[i].dirty) { return true; }
+  } // for
+  return false;
+} // dirty
+
+/*
+ * Send the changed rows of every tile to its display. A row that fails is
+ * kept dirty, so the next refresh() tries it again.
+ *
+ * returns: false if any display failed to communicate.
+ */
+bool SerLCDTiledDisplay::refresh() {
+  bool ok = true;
+
+  for (byte i = 0; i < _tileCount; i++) {
+    Tile &tile = _tiles[i];
+
+    for (byte row = 0; row < tile.rows && tile.dirty; row++) {
+      if (!(tile.dirty & (1 << row))) { continue; }
+
+      //Sent with its length, so cells holding custom character 0 are data too
+      const char *line = &_buffer[(unsigned int)(tile.row + row) * _cols + tile.col];
+
+      if (tile.lcd->update(0, row, line, tile.cols, tile.cols)) { tile.dirty &= ~(1 << row); }
+      else { ok = false; }
+    } // for
+  } // for
+
+  return ok;
+} // refresh
+
+/*
+ * Mark every tile as changed, e.g. after a display was cleared or
+ * written to directly, so the next refresh() brings them all up to date.
+ */
+void SerLCDTiledDisplay::invalidate() {
+  for (byte i = 0; i < _tileCount; i++) {
+    _tiles[i].dirty = (1 << _tiles[i].rows) - 1;
+  } // for
+} // invalidate
+
+/*
+ * Flag the row of the tile that shows a cell. Cells outside every tile
+ * are kept in the framebuffer only.
+ */
+void SerLCDTiledDisplay::markDirty(byte col, byte row) {
+  for (byte i = 0; i < _tileCount; i++) {
+    Tile &tile = _tiles[i];
+    if (col >= tile.col && col < tile.col + tile.cols &&
+        row >= tile.row && row < tile.row + tile.rows) {
+      tile.dirty |= 1 << (row - tile.row);
+    }
+  } // for
+} // markDirty
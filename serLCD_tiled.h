@@ -0,0 +1,49 @@
+#ifndef SER_LCD_TILED_H
+#define SER_LCD_TILED_H
+
+#include "serLCD_cI2C.h"
+
+#ifndef TILED_MAX_TILES
+#define TILED_MAX_TILES 4 //Displays one virtual screen can span
+#endif
+
+/*
+ * A virtual screen made of several displays, e.g. two 20x4 side by side as
+ * one 40x4, or stacked as one 20x8. Text is written into a single
+ * framebuffer; refresh() then sends each display only the rows of its tile
+ * that changed, and SerLCD::update() sends only the cells within those rows
+ * that differ. A display whose tile didn't change is not touched at all.
+ */
+class SerLCDTiledDisplay : public Print {
+
+public:
+  SerLCDTiledDisplay(char *buffer, byte cols, byte rows);
+  bool addTile(SerLCD &lcd, byte col, byte row, byte cols = MAX_COLUMNS, byte rows = MAX_ROWS);
+  virtual size_t write(uint8_t c);
+  void setCursor(byte col, byte row);
+  void clear();
+  char charAt(byte col, byte row) const;
+  bool dirty() const;
+  bool refresh();
+  void invalidate();
+private:
+  struct Tile {
+    SerLCD *lcd;
+    byte col;    //Position of the tile on the virtual screen
+    byte row;
+    byte cols;   //Size of the tile
+    byte rows;
+    byte dirty;  //One bit per tile row changed since the last refresh
+  };
+  char *_buffer; //cols * rows characters, row after row
+  byte _cols;
+  byte _rows;
+  byte _col = 0; //Virtual cursor
+  byte _row = 0;
+  Tile _tiles[TILED_MAX_TILES];
+  byte _tileCount = 0;
+
+  void markDirty(byte col, byte row);
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef SER_LCD_TRANSPORT_H
+#define SER_LCD_TRANSPORT_H
+
+#include <stdint.h>
+
+/*
+ * A connection to the OpenLCD other than the I2C, Stream and SPI classes,
+ * e.g. a Linux device node. SerLCD brackets every command in
+ * beginTransmission()/endTransmission() and sends its bytes one at a time
+ * with transmit(), so a transport can gather a whole transaction and send it
+ * in one go. Only depends on the C library, so transports can be built
+ * without the Arduino core.
+ */
+class SerLCDTransport {
+
+public:
+  virtual ~SerLCDTransport() {}
+  virtual bool beginTransmission() = 0;
+  virtual bool transmit(uint8_t data) = 0;
+  virtual bool endTransmission() = 0;
+  virtual void setAddress(uint8_t) {} //Called after SerLCD::setAddress() moved the display
+
+  //For SerLCD::busTime(): bits on the wire per byte, and bytes of addressing
+  //added to every transaction. The defaults are those of I2C.
+  virtual uint8_t bitsPerByte() const { return 9; }
+  virtual uint8_t headerBytes() const { return 1; }
+
+  //For event loops: a transport that queues output reports the descriptor to
+  //wait on, and writeMore() is called whenever it becomes writable.
+  virtual int fd() const { return -1; }
+  virtual bool writePending() const { return false; }
+  virtual bool writeMore() { return true; }
+
+  //A transport that paces its output reports how long in microseconds the
+  //pending output is held back, so the loop waits for that instead of writability.
+  virtual unsigned long writeDelay() const { return 0; }
+};
+
+#endif
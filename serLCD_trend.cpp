@@ -0,0 +1,135 @@
+/*
+ * Rolling trend plot for the SerLCD.
+ *
+ * Usage:
+ *   SerLCDTrendPlot trend(4, 1, 20.0, 80.0); //20 samples, 8 pixels high
+ *   trend.place(lcd, 16, 0);
+ *   trend.start(lcd);                     //Upload glyphs from service()
+ *   ...
+ *   trend.addSample(lcd, temperature);    //Draws the plot in RAM
+ *   lcd.service();                        //Uploads a changed glyph when the display is ready
+ *
+ * Samples are kept as pixel heights, so the whole plot is redrawn in RAM for each
+ * sample and the canvas decides which of the glyphs need to be sent.
+ */
+#include "serLCD_trend.h"
+
+#define NO_SAMPLE 0xFF
+
+/*
+ * byte  cellsWide, cellsHigh - plot size in character cells (see SerLCDCanvas)
+ * float minValue, maxValue   - values mapped to the bottom and top pixel rows
+ * byte  firstLocation        - first CGRAM slot to use
+ */
+SerLCDTrendPlot::SerLCDTrendPlot(byte cellsWide, byte cellsHigh, float minValue, float maxValue, byte firstLocation)
+  : _canvas(cellsWide, cellsHigh, firstLocation), _minValue(minValue), _maxValue(maxValue) {
+  reset();
+}
+
+/*
+ * Change the scaling. Samples already plotted keep their old scaling.
+ */
+void SerLCDTrendPlot::setRange(float minValue, float maxValue) {
+  _minValue = minValue;
+  _maxValue = maxValue;
+} // setRange
+
+/*
+ * Choose between TREND_LINE and TREND_BAR. Takes effect on the next sample.
+ */
+void SerLCDTrendPlot::setStyle(byte style) {
+  _style = style;
+} // setStyle
+
+/*
+ * Drop all samples.
+ */
+void SerLCDTrendPlot::reset() {
+  memset(_columns, NO_SAMPLE, sizeof(_columns));
+  _canvas.clear();
+} // reset
+
+/*
+ * Write the plot glyphs onto the screen with its top left cell at col, row.
+ */
+bool SerLCDTrendPlot::place(SerLCD &lcd, byte col, byte row) {
+  return _canvas.place(lcd, col, row);
+} // place
+
+/*
+ * Attach the plot to a display, so that the glyphs changed by addSample()
+ * are uploaded one per service() call. Turns on deferred settling, so
+ * service() doesn't wait out the pause after each upload.
+ */
+void SerLCDTrendPlot::start(SerLCD &lcd) {
+  _started = true;
+  lcd.deferSettling(true);
+  lcd.attach(*this);
+  if (_canvas.dirty()) { schedule(millis()); }
+} // start
+
+/*
+ * Scroll the plot left by one column and plot value in the rightmost column.
+ * The glyphs that changed are uploaded by service() after start(), or right
+ * away otherwise.
+ */
+bool SerLCDTrendPlot::addSample(SerLCD &lcd, float value) {
+  byte w = _canvas.width();
+
+  memmove(_columns, _columns + 1, w - 1);
+  _columns[w - 1] = scale(value);
+
+  render();
+  if (_started) {
+    schedule(millis());
+    return true;
+  }
+  return _canvas.flush(lcd);
+} // addSample
+
+/*
+ * Upload one changed glyph, and come back for the next while any are left.
+ * A glyph that changes again before its turn is only uploaded once.
+ */
+bool SerLCDTrendPlot::run(SerLCD &lcd, unsigned long now) {
+  bool ok = _canvas.flush(lcd, 1);
+
+  if (_canvas.dirty()) { schedule(now); }
+  return ok;
+} // run
+
+/*
+ * Map a value to a pixel height, 0 being the bottom row. Out of range values are clamped.
+ */
+byte SerLCDTrendPlot::scale(float value) const {
+  byte top = _canvas.height() - 1;
+
+  if (_maxValue <= _minValue || value <= _minValue) { return 0; }
+  if (value >= _maxValue) { return top; }
+
+  return (byte)((value - _minValue) * top / (_maxValue - _minValue) + 0.5);
+} // scale
+
+/*
+ * Redraw the canvas from the column data.
+ */
+void SerLCDTrendPlot::render() {
+  byte w = _canvas.width();
+  byte bottom = _canvas.height() - 1;
+
+  _canvas.clear();
+  for (byte x = 0; x < w; x++) {
+    if (_columns[x] == NO_SAMPLE) { continue; }
+
+    byte y = bottom - _columns[x];
+    if (_style == TREND_BAR) {
+      _canvas.drawLine(x, y, x, bottom);
+    }
+    else if (x > 0 && _columns[x - 1] != NO_SAMPLE) {
+      _canvas.drawLine(x - 1, bottom - _columns[x - 1], x, y);
+    }
+    else {
+      _canvas.setPixel(x, y);
+    }
+  } // for
+} // render
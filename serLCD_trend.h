@@ -0,0 +1,44 @@
+#ifndef SER_LCD_TREND_H
+#define SER_LCD_TREND_H
+
+#include "serLCD_canvas.h"
+
+//Trend plot styles
+#define TREND_LINE 0 //Join the samples with lines
+#define TREND_BAR  1 //Fill each column from the bottom up to its sample
+
+#define TREND_MAX_SAMPLES (CANVAS_MAX_CELLS * CELL_WIDTH)
+
+/*
+ * A scrolling strip chart drawn on a SerLCDCanvas. One pixel column per sample;
+ * new samples enter on the right and old ones scroll off to the left.
+ * Scrolling changes every glyph the plot covers, and each takes about 50 ms
+ * to upload. Once start() has attached the plot to its display, addSample()
+ * only draws in RAM and service() uploads one changed glyph per call;
+ * without start() addSample() uploads them all before returning.
+ */
+class SerLCDTrendPlot : public SerLCDTask {
+
+public:
+  SerLCDTrendPlot(byte cellsWide, byte cellsHigh, float minValue, float maxValue, byte firstLocation = 0);
+  void setRange(float minValue, float maxValue);
+  void setStyle(byte style);
+  void reset();
+  bool place(SerLCD &lcd, byte col, byte row);
+  void start(SerLCD &lcd);
+  bool addSample(SerLCD &lcd, float value);
+  SerLCDCanvas &canvas() { return _canvas; }
+  virtual bool run(SerLCD &lcd, unsigned long now);
+  virtual byte cost() const { return 10; } //Setting command, slot and 8 bitmap bytes
+private:
+  SerLCDCanvas _canvas;
+  bool  _started = false;            //Uploads are left to service()
+  float _minValue;
+  float _maxValue;
+  byte  _style = TREND_LINE;
+  byte  _columns[TREND_MAX_SAMPLES]; //Pixel height of each sample, oldest first; NO_SAMPLE if empty
+  byte scale(float value) const;
+  void render();
+};
+
+#endif